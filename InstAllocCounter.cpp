@@ -0,0 +1,65 @@
+/*
+ * InstAllocCounter.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstAllocCounter.h"
+
+#ifdef LB_COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+unsigned allocCount = 0u;
+unsigned expectedDepth = 0u;
+
+void* countedAlloc(std::size_t size) {
+    if (!expectedDepth) {
+        ++allocCount;
+    }
+    void* ptr = std::malloc(size ? size : 1u);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+} /* namespace */
+
+void* operator new(std::size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+namespace lb {
+
+unsigned InstAllocCounter::getCount() {
+    return allocCount;
+}
+
+InstAllocCounter::Expected::Expected() {
+    ++expectedDepth;
+}
+
+InstAllocCounter::Expected::~Expected() {
+    --expectedDepth;
+}
+
+} /* namespace lb */
+
+#endif
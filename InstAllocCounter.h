@@ -0,0 +1,61 @@
+/*
+ * InstAllocCounter.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTALLOCCOUNTER_H_
+#define INSTALLOCCOUNTER_H_
+
+namespace lb {
+
+/**
+ * global heap allocation counter,
+ * built with LB_COUNT_ALLOCATIONS (cmake -DCOUNT_ALLOCATIONS=ON, make COUNT_ALLOCATIONS=1)
+ * operator new is replaced and every call is counted,
+ * otherwise nothing is counted and every call compiles away
+ */
+class InstAllocCounter {
+public:
+#ifdef LB_COUNT_ALLOCATIONS
+    constexpr static bool enabled = true;
+#else
+    constexpr static bool enabled = false;
+#endif
+
+    /**
+     * allocations made so far, outside Expected scopes
+     */
+    static unsigned getCount();
+
+    /**
+     * scope of an expected allocation (lazy page growth), not counted
+     */
+    class Expected {
+    public:
+        Expected();
+
+        ~Expected();
+
+        Expected(const Expected& that) = delete;
+
+        Expected& operator=(const Expected& that) = delete;
+    };
+};
+
+#ifndef LB_COUNT_ALLOCATIONS
+inline unsigned InstAllocCounter::getCount() {
+    return 0u;
+}
+
+inline InstAllocCounter::Expected::Expected() {
+}
+
+inline InstAllocCounter::Expected::~Expected() {
+}
+#endif
+
+} /* namespace lb */
+
+#endif /* INSTALLOCCOUNTER_H_ */
@@ -0,0 +1,442 @@
+/*
+ * InstBatchSimulator.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstBatchSimulator.h"
+
+namespace lb {
+
+constexpr unsigned InstBatchSimulator::LANES;
+constexpr unsigned InstBatchSimulator::MEMORY_WORDS;
+constexpr unsigned InstBatchSimulator::ALL_LANES;
+
+namespace {
+
+/**
+ * lanes where a + b overflows: the signs of a and b agree and differ from the sum,
+ * a - b is checked as a + (0 - b) like InstErrorDetector::isOverflowed()
+ */
+unsigned getOverflowMask(const unsigned* a, const unsigned* b, const unsigned* sum) {
+    unsigned ret = 0u;
+    for (unsigned l = 0; l < InstBatchSimulator::LANES; ++l) {
+        ret |= (((a[l] ^ sum[l]) & (b[l] ^ sum[l])) >> 31) << l;
+    }
+    return ret;
+}
+
+}
+
+InstBatchSimulator::InstBatchSimulator() {
+    init();
+}
+
+InstBatchSimulator::~InstBatchSimulator() {
+
+}
+
+void InstBatchSimulator::init() {
+    decodeCache.init();
+    pcOriginal = 0u;
+    splitCount = 0u;
+    clearLanes();
+}
+
+void InstBatchSimulator::loadImageI(std::vector<unsigned>&& src, const unsigned& pc) {
+    decodeCache.load(std::move(src), pc);
+    pcOriginal = pc;
+}
+
+void InstBatchSimulator::clearLanes() {
+    laneCount = 0u;
+    groups.clear();
+}
+
+bool InstBatchSimulator::addLane(const unsigned* src, const unsigned& len, const unsigned& sp,
+                                 FILE* snapshot, FILE* errorDump) {
+    if (laneCount == LANES) {
+        return false;
+    }
+    const unsigned l = laneCount++;
+    lane[l].snapshot = snapshot;
+    lane[l].errorDump = errorDump;
+    lane[l].pc = pcOriginal;
+    lane[l].instCount = 0u;
+    for (unsigned i = 0; i < 32; ++i) {
+        reg[i][l] = 0u;
+    }
+    // $sp -> $29
+    reg[29][l] = sp;
+    for (unsigned i = 0; i < MEMORY_WORDS; ++i) {
+        mem[i][l] = (i < len) ? src[i] : 0u;
+    }
+    return true;
+}
+
+unsigned InstBatchSimulator::getLaneCount() const {
+    return laneCount;
+}
+
+unsigned InstBatchSimulator::getSplitCount() const {
+    return splitCount;
+}
+
+void InstBatchSimulator::simulate() {
+    groups.clear();
+    if (laneCount) {
+        InstBatchGroup group;
+        group.pc = pcOriginal;
+        group.instCount = 0u;
+        group.mask = ALL_LANES >> (LANES - laneCount);
+        groups.push_back(group);
+    }
+    while (!groups.empty()) {
+        const InstBatchGroup group = groups.back();
+        groups.pop_back();
+        runGroup(group);
+    }
+    for (unsigned l = 0; l < laneCount; ++l) {
+        if (lane[l].snapshot) {
+            dumpRegister(l);
+        }
+    }
+}
+
+void InstBatchSimulator::runGroup(InstBatchGroup group) {
+    unsigned next[LANES];
+    while (group.mask) {
+        const unsigned instPc = group.pc;
+        const InstDataBin& inst = decodeCache.fetch(instPc);
+        ++group.instCount;
+        if (inst.isClass(InstClass::HALT)) {
+            finishLanes(group.mask, instPc, group.instCount);
+            return;
+        }
+        if (inst.isClass(InstClass::BRANCH)) {
+            executeBranch(inst, instPc, group.mask, next);
+            // the lowest lane keeps the group, lanes going elsewhere wait in groups of their own
+            unsigned first = 0u;
+            while (!((group.mask >> first) & 1u)) {
+                ++first;
+            }
+            group.pc = next[first];
+            unsigned rest = 0u;
+            for (unsigned l = first; l < LANES; ++l) {
+                if (((group.mask >> l) & 1u) && next[l] != group.pc) {
+                    rest |= 1u << l;
+                }
+            }
+            group.mask &= ~rest;
+            while (rest) {
+                unsigned l = 0u;
+                while (!((rest >> l) & 1u)) {
+                    ++l;
+                }
+                InstBatchGroup split;
+                split.pc = next[l];
+                split.instCount = group.instCount;
+                split.mask = 0u;
+                for (; l < LANES; ++l) {
+                    if (((rest >> l) & 1u) && next[l] == split.pc) {
+                        split.mask |= 1u << l;
+                    }
+                }
+                rest &= ~split.mask;
+                groups.push_back(split);
+                ++splitCount;
+            }
+            continue;
+        }
+        const unsigned halted = execute(inst, group.mask, group.instCount);
+        if (halted) {
+            finishLanes(halted, instPc, group.instCount);
+            group.mask &= ~halted;
+        }
+        group.pc = instPc + 4u;
+    }
+}
+
+unsigned InstBatchSimulator::execute(const InstDataBin& inst, const unsigned& mask, const unsigned& instCount) {
+    const unsigned* valRs = reg[inst.getRs()];
+    const unsigned* valRt = reg[inst.getRt()];
+    const unsigned valC = inst.getC();
+    const unsigned imm = toUnsigned(toSigned(valC, 16));
+    unsigned operand[LANES];
+    unsigned ALUOut[LANES];
+    unsigned MDR[LANES];
+    unsigned overflow = 0u;
+    switch (static_cast<InstExOp>(inst.getExOp())) {
+        case InstExOp::NONE:
+        case InstExOp::ZERO:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = 0u;
+            }
+            break;
+        case InstExOp::ADD:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRs[l] + valRt[l];
+            }
+            overflow = getOverflowMask(valRs, valRt, ALUOut);
+            break;
+        case InstExOp::ADDU:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRs[l] + valRt[l];
+            }
+            break;
+        case InstExOp::SUB:
+            for (unsigned l = 0; l < LANES; ++l) {
+                operand[l] = 0u - valRt[l];
+                ALUOut[l] = valRs[l] + operand[l];
+            }
+            overflow = getOverflowMask(valRs, operand, ALUOut);
+            break;
+        case InstExOp::AND:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRs[l] & valRt[l];
+            }
+            break;
+        case InstExOp::OR:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRs[l] | valRt[l];
+            }
+            break;
+        case InstExOp::XOR:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRs[l] ^ valRt[l];
+            }
+            break;
+        case InstExOp::NOR:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = ~(valRs[l] | valRt[l]);
+            }
+            break;
+        case InstExOp::NAND:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = ~(valRs[l] & valRt[l]);
+            }
+            break;
+        case InstExOp::SLT:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = static_cast<unsigned>(toSigned(valRs[l]) < toSigned(valRt[l]));
+            }
+            break;
+        case InstExOp::SLL:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRt[l] << valC;
+            }
+            break;
+        case InstExOp::SRL:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRt[l] >> valC;
+            }
+            break;
+        case InstExOp::SRA:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = static_cast<unsigned>(toSigned(valRt[l]) >> static_cast<int>(valC));
+            }
+            break;
+        case InstExOp::ADDI:
+        case InstExOp::MEMADDR:
+            for (unsigned l = 0; l < LANES; ++l) {
+                operand[l] = imm;
+                ALUOut[l] = valRs[l] + imm;
+            }
+            overflow = getOverflowMask(valRs, operand, ALUOut);
+            break;
+        case InstExOp::ADDIU:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRs[l] + imm;
+            }
+            break;
+        case InstExOp::LUI:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valC << 16;
+            }
+            break;
+        case InstExOp::ANDI:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRs[l] & valC;
+            }
+            break;
+        case InstExOp::ORI:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = valRs[l] | valC;
+            }
+            break;
+        case InstExOp::NORI:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = ~(valRs[l] | valC);
+            }
+            break;
+        case InstExOp::SLTI:
+            for (unsigned l = 0; l < LANES; ++l) {
+                ALUOut[l] = static_cast<unsigned>(toSigned(valRs[l]) < toSigned(valC, 16));
+            }
+            break;
+    }
+    if (overflow & mask) {
+        reportError(overflow & mask, instCount, "Number Overflow");
+    }
+    unsigned halted = 0u;
+    if (static_cast<InstDmOp>(inst.getDmOp()) != InstDmOp::NONE) {
+        halted = accessMemory(inst, mask, ALUOut, MDR, instCount);
+    }
+    const unsigned live = mask & ~halted;
+    const InstWbOp wbOp = static_cast<InstWbOp>(inst.getWbOp());
+    if (wbOp != InstWbOp::NONE && live) {
+        const unsigned rd = inst.getRegWrite().at(0).val;
+        if (!InstErrorDetector::isRegWritable(rd)) {
+            reportError(live, instCount, "Write $0 Error");
+        }
+        else {
+            const unsigned* val = (wbOp == InstWbOp::MDR) ? MDR : ALUOut;
+            unsigned* dst = reg[rd];
+            for (unsigned l = 0; l < LANES; ++l) {
+                dst[l] = ((live >> l) & 1u) ? val[l] : dst[l];
+            }
+        }
+    }
+    return halted;
+}
+
+void InstBatchSimulator::executeBranch(const InstDataBin& inst, const unsigned& instPc, const unsigned& mask,
+                                       unsigned* next) {
+    if (inst.isClass(InstClass::BRANCH_R)) {
+        const unsigned* valRs = reg[inst.getRs()];
+        for (unsigned l = 0; l < LANES; ++l) {
+            next[l] = valRs[l];
+        }
+    }
+    else if (inst.isClass(InstClass::BRANCH_I)) {
+        const unsigned* valRs = reg[inst.getRs()];
+        const unsigned* valRt = reg[inst.getRt()];
+        const unsigned target = instPc + 4 + toUnsigned(4 * toSigned(inst.getC(), 16));
+        const unsigned opCode = inst.getOpCode();
+        for (unsigned l = 0; l < LANES; ++l) {
+            bool result;
+            switch (opCode) {
+                case 0x04u:
+                    result = (valRs[l] == valRt[l]);
+                    break;
+                case 0x05u:
+                    result = (valRs[l] != valRt[l]);
+                    break;
+                case 0x07u:
+                    result = (toSigned(valRs[l]) > 0);
+                    break;
+                default:
+                    result = false;
+                    break;
+            }
+            next[l] = result ? target : instPc + 4;
+        }
+    }
+    else {
+        if (inst.getOpCode() == 0x03u) {
+            for (unsigned l = 0; l < LANES; ++l) {
+                reg[31][l] = ((mask >> l) & 1u) ? instPc + 4 : reg[31][l];
+            }
+        }
+        const unsigned target = ((instPc + 4) & 0xF0000000u) | (inst.getC() * 4);
+        for (unsigned l = 0; l < LANES; ++l) {
+            next[l] = target;
+        }
+    }
+}
+
+unsigned InstBatchSimulator::accessMemory(const InstDataBin& inst, const unsigned& mask, const unsigned* addr,
+                                          unsigned* MDR, const unsigned& instCount) {
+    const InstDmOp op = static_cast<InstDmOp>(inst.getDmOp());
+    InstSize type = InstSize::BYTE;
+    if (op == InstDmOp::LW || op == InstDmOp::SW) {
+        type = InstSize::WORD;
+    }
+    else if (op == InstDmOp::LH || op == InstDmOp::LHU || op == InstDmOp::SH) {
+        type = InstSize::HALF;
+    }
+    unsigned overflow = 0u;
+    unsigned misaligned = 0u;
+    for (unsigned l = 0; l < LANES; ++l) {
+        overflow |= static_cast<unsigned>(!InstErrorDetector::isValidMemoryAddr(addr[l], type)) << l;
+        misaligned |= static_cast<unsigned>(!InstErrorDetector::isAlignedAddr(addr[l], type)) << l;
+    }
+    overflow &= mask;
+    misaligned &= mask;
+    if (overflow) {
+        reportError(overflow, instCount, "Address Overflow");
+    }
+    if (misaligned) {
+        reportError(misaligned, instCount, "Misalignment Error");
+    }
+    const unsigned live = mask & ~(overflow | misaligned);
+    const unsigned* valRt = reg[inst.getRt()];
+    // words are big-endian, HALF and BYTE are shifted out of the word holding them
+    for (unsigned l = 0; l < LANES; ++l) {
+        if (!((live >> l) & 1u)) {
+            continue;
+        }
+        unsigned& word = mem[addr[l] >> 2][l];
+        const unsigned halfShift = (~addr[l] & 2u) << 3;
+        const unsigned byteShift = (~addr[l] & 3u) << 3;
+        switch (op) {
+            case InstDmOp::NONE:
+                break;
+            case InstDmOp::LW:
+                MDR[l] = word;
+                break;
+            case InstDmOp::LH:
+                MDR[l] = toUnsigned(toSigned((word >> halfShift) & 0x0000FFFFu, InstSize::HALF));
+                break;
+            case InstDmOp::LHU:
+                MDR[l] = (word >> halfShift) & 0x0000FFFFu;
+                break;
+            case InstDmOp::LB:
+                MDR[l] = toUnsigned(toSigned((word >> byteShift) & 0x000000FFu, InstSize::BYTE));
+                break;
+            case InstDmOp::LBU:
+                MDR[l] = (word >> byteShift) & 0x000000FFu;
+                break;
+            case InstDmOp::SW:
+                word = valRt[l];
+                break;
+            case InstDmOp::SH:
+                word = (word & ~(0x0000FFFFu << halfShift)) | ((valRt[l] & 0x0000FFFFu) << halfShift);
+                break;
+            case InstDmOp::SB:
+                word = (word & ~(0x000000FFu << byteShift)) | ((valRt[l] & 0x000000FFu) << byteShift);
+                break;
+        }
+    }
+    return overflow | misaligned;
+}
+
+void InstBatchSimulator::finishLanes(const unsigned& mask, const unsigned& instPc, const unsigned& instCount) {
+    for (unsigned l = 0; l < laneCount; ++l) {
+        if ((mask >> l) & 1u) {
+            lane[l].pc = instPc;
+            lane[l].instCount = instCount;
+        }
+    }
+}
+
+void InstBatchSimulator::reportError(const unsigned& mask, const unsigned& instCount, const char* message) {
+    for (unsigned l = 0; l < laneCount; ++l) {
+        if (((mask >> l) & 1u) && lane[l].errorDump) {
+            fprintf(lane[l].errorDump, "In cycle %u: %s\n", instCount, message);
+        }
+    }
+}
+
+void InstBatchSimulator::dumpRegister(const unsigned& l) {
+    FILE* fp = lane[l].snapshot;
+    fprintf(fp, "cycle %u\n", lane[l].instCount);
+    for (unsigned i = 0; i < 32; ++i) {
+        fprintf(fp, "$%02d: 0x%08X\n", i, reg[i][l]);
+    }
+    fprintf(fp, "PC: 0x%08X\n", lane[l].pc);
+    fprintf(fp, "\n\n");
+}
+
+} /* namespace lb */
@@ -0,0 +1,152 @@
+/*
+ * InstBatchSimulator.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTBATCHSIMULATOR_H_
+#define INSTBATCHSIMULATOR_H_
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+#include "InstDataBin.h"
+#include "InstDecodeCache.h"
+#include "InstErrorDetector.h"
+#include "InstType.h"
+#include "InstUtility.h"
+
+namespace lb {
+
+/**
+ * functional(ISA level) simulation of up to LANES copies of one program in lockstep,
+ * each lane has its own registers and FLAT data memory, kept lane-minor(SoA)
+ * so every instruction is decoded once and applied to all lanes in a plain loop.
+ * lanes with the same pc form a group, a branch whose lanes disagree splits the group,
+ * the split groups run one after another, a lane halted by a fatal error leaves its group.
+ * results and error dumps are the same as InstSimulator::simulateFunctional() per lane
+ */
+class InstBatchSimulator {
+public:
+    constexpr static unsigned LANES = 16u;
+
+public:
+    InstBatchSimulator();
+
+    InstBatchSimulator(const InstBatchSimulator& that) = delete;
+
+    virtual ~InstBatchSimulator();
+
+    InstBatchSimulator& operator=(const InstBatchSimulator& that) = delete;
+
+    /**
+     * drop the instruction image and the lanes
+     */
+    void init();
+
+    /**
+     * instruction image shared by all lanes, taken without copying
+     * @param src instruction words
+     * @param pc address of the first word
+     */
+    void loadImageI(std::vector<unsigned>&& src, const unsigned& pc);
+
+    /**
+     * drop the lanes, the instruction image is kept
+     */
+    void clearLanes();
+
+    /**
+     * add a lane, registers start at 0 with $sp, memory past 1 KiB is dropped
+     * @param src data image words
+     * @param len number of words
+     * @param sp initial $sp
+     * @param snapshot final registers, nullptr for none
+     * @param errorDump errors, nullptr for none
+     * @return false if LANES lanes are added already
+     */
+    bool addLane(const unsigned* src, const unsigned& len, const unsigned& sp, FILE* snapshot, FILE* errorDump);
+
+    unsigned getLaneCount() const;
+
+    /**
+     * run every lane to its halt or fatal error, then write the final registers
+     */
+    void simulate();
+
+    /**
+     * number of times a group split since init()
+     */
+    unsigned getSplitCount() const;
+
+private:
+    constexpr static unsigned MEMORY_WORDS = 256u;
+    constexpr static unsigned ALL_LANES = 0xFFFFFFFFu >> (32u - LANES);
+
+private:
+    /**
+     * lanes at the same pc, mask: one bit per lane
+     */
+    struct InstBatchGroup {
+        unsigned pc;
+        unsigned instCount;
+        unsigned mask;
+    };
+
+    /**
+     * per lane output and final state
+     */
+    struct InstBatchLane {
+        FILE* snapshot;
+        FILE* errorDump;
+        unsigned pc;
+        unsigned instCount;
+    };
+
+private:
+    InstDecodeCache decodeCache;
+    unsigned pcOriginal;
+    unsigned laneCount;
+    unsigned splitCount;
+    InstBatchLane lane[LANES];
+    // reg[r][l], mem[word][l]: register r and memory word of lane l
+    unsigned reg[32][LANES];
+    unsigned mem[MEMORY_WORDS][LANES];
+    // lanes waiting at their own pc, newest last
+    std::vector<InstBatchGroup> groups;
+
+private:
+    void runGroup(InstBatchGroup group);
+
+    /**
+     * execute a non-branch instruction on the lanes of mask
+     * @return lanes halted by a fatal error
+     */
+    unsigned execute(const InstDataBin& inst, const unsigned& mask, const unsigned& instCount);
+
+    /**
+     * next pc of each lane of mask after a branch, jal links every lane
+     */
+    void executeBranch(const InstDataBin& inst, const unsigned& instPc, const unsigned& mask, unsigned* next);
+
+    /**
+     * load or store for the lanes of mask at addr
+     * @return lanes halted by a fatal error
+     */
+    unsigned accessMemory(const InstDataBin& inst, const unsigned& mask, const unsigned* addr,
+                          unsigned* MDR, const unsigned& instCount);
+
+    /**
+     * lanes of mask leave at instPc
+     */
+    void finishLanes(const unsigned& mask, const unsigned& instPc, const unsigned& instCount);
+
+    void reportError(const unsigned& mask, const unsigned& instCount, const char* message);
+
+    void dumpRegister(const unsigned& l);
+};
+
+} /* namespace lb */
+
+#endif /* INSTBATCHSIMULATOR_H_ */
@@ -0,0 +1,274 @@
+/*
+ * InstBenchmark.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "InstBatchSimulator.h"
+#include "InstDecoder.h"
+#include "InstSimulator.h"
+
+namespace {
+
+/**
+ * xorshift32, deterministic random words
+ */
+unsigned nextRandom(unsigned& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void report(const char* name, const unsigned long long& count, const char* unit, const double& seconds,
+            const unsigned& checksum) {
+    printf("%-16s %12llu %s %8.3f s %10.2f M %s/s (checksum %08X)\n",
+           name, count, unit, seconds, count / seconds / 1e6, unit, checksum);
+}
+
+void benchmarkDecode(const unsigned long long& count) {
+    unsigned state = 2463534242u;
+    unsigned checksum = 0u;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (unsigned long long i = 0; i < count; ++i) {
+        const lb::InstDataBin inst = lb::InstDecoder::decodeInstBin(nextRandom(state));
+        checksum += inst.getC() ^ inst.getInstNameId() ^ inst.getExOp() ^ inst.getRegRead().size();
+    }
+    report("decodeInstBin", count, "words", elapsedSeconds(begin), checksum);
+    state = 2463534242u;
+    checksum = 0u;
+    begin = std::chrono::steady_clock::now();
+    for (unsigned long long i = 0; i < count; ++i) {
+        const lb::InstDataStr inst = lb::InstDecoder::decodeInstStr(nextRandom(state));
+        checksum += static_cast<unsigned>(inst.getOpCode().size() + inst.getC().size());
+    }
+    report("decodeInstStr", count, "words", elapsedSeconds(begin), checksum);
+}
+
+unsigned encodeI(const unsigned& opCode, const unsigned& rs, const unsigned& rt, const int& c) {
+    return (opCode << 26) | (rs << 21) | (rt << 16) | (static_cast<unsigned>(c) & 0xFFFFu);
+}
+
+/**
+ * load/store heavy loop, 8 memory accesses out of 11 instructions per iteration,
+ * run on the quiet pipeline and on the functional core
+ */
+void benchmarkMemory(const unsigned& iterations) {
+    unsigned inst[20];
+    unsigned len = 0u;
+    inst[len++] = encodeI(0x0Fu, 0u, 1u, static_cast<int>(iterations >> 16));    // lui $1, hi
+    inst[len++] = encodeI(0x0Du, 1u, 1u, static_cast<int>(iterations & 0xFFFFu)); // ori $1, $1, lo
+    inst[len++] = encodeI(0x23u, 0u, 2u, 0);      // loop: lw $2, 0($0)
+    inst[len++] = encodeI(0x2Bu, 0u, 2u, 4);      // sw $2, 4($0)
+    inst[len++] = encodeI(0x21u, 0u, 3u, 10);     // lh $3, 10($0)
+    inst[len++] = encodeI(0x29u, 0u, 3u, 12);     // sh $3, 12($0)
+    inst[len++] = encodeI(0x20u, 0u, 4u, 17);     // lb $4, 17($0)
+    inst[len++] = encodeI(0x28u, 0u, 4u, 23);     // sb $4, 23($0)
+    inst[len++] = encodeI(0x25u, 0u, 5u, 6);      // lhu $5, 6($0)
+    inst[len++] = encodeI(0x24u, 0u, 6u, 3);      // lbu $6, 3($0)
+    inst[len++] = encodeI(0x08u, 1u, 1u, -1);     // addi $1, $1, -1
+    inst[len++] = encodeI(0x05u, 1u, 0u, -10);    // bne $1, $0, loop
+    while (len < 20u) {
+        inst[len++] = 0xFFFFFFFFu;                // halt, fills the pipeline
+    }
+    unsigned data[256];
+    unsigned state = 2463534242u;
+    for (unsigned i = 0; i < 256u; ++i) {
+        data[i] = nextRandom(state);
+    }
+    const unsigned long long count = 8ull * iterations;
+    lb::InstMemory memory;
+    memory.loadMemory(data, 256u);
+    unsigned checksum = 0u;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; ++i) {
+        const unsigned addr = (i << 2) & 0x3F8u;
+        checksum += memory.getMemory(addr, lb::InstSize::WORD);
+        memory.setMemory(addr + 4u, checksum, lb::InstSize::WORD);
+        checksum += memory.getMemory(addr + 2u, lb::InstSize::HALF);
+        memory.setMemory(addr + 6u, checksum, lb::InstSize::HALF);
+        checksum += memory.getMemory(addr + 1u, lb::InstSize::BYTE);
+        memory.setMemory(addr + 7u, checksum, lb::InstSize::BYTE);
+        checksum += memory.getMemory(addr + 4u, lb::InstSize::HALF);
+        checksum += memory.getMemory(addr + 3u, lb::InstSize::BYTE);
+    }
+    report("InstMemory", count, "accesses", elapsedSeconds(begin), checksum);
+    lb::InstSimulatorQuietStats* pipeline = new lb::InstSimulatorQuietStats();
+    pipeline->loadImageI(inst, len, 0u);
+    pipeline->loadImageD(data, 256u, 0x400u);
+    begin = std::chrono::steady_clock::now();
+    pipeline->simulate();
+    report("pipeline", count, "accesses", elapsedSeconds(begin), pipeline->getStats().getCycle());
+    delete pipeline;
+    lb::InstSimulatorQuiet* functional = new lb::InstSimulatorQuiet();
+    functional->loadImageI(inst, len, 0u);
+    functional->loadImageD(data, 256u, 0x400u);
+    begin = std::chrono::steady_clock::now();
+    functional->simulateFunctional();
+    report("functional", count, "accesses", elapsedSeconds(begin), 0u);
+    delete functional;
+}
+
+/**
+ * large image, only the first few instructions run,
+ * load and run time should not depend on image size
+ */
+void benchmarkStartup(const unsigned& words) {
+    std::vector<unsigned> inst(words, 0u);
+    for (unsigned i = 0; i < 8u && i < words; ++i) {
+        inst[i] = 0xFFFFFFFFu;
+    }
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    lb::InstSimulatorQuietStats* simulator = new lb::InstSimulatorQuietStats();
+    simulator->loadImageI(std::move(inst), 0u);
+    simulator->simulate();
+    report("startup", words, "words", elapsedSeconds(begin), simulator->getStats().getCycle());
+    delete simulator;
+}
+
+/**
+ * many short programs on one reused instance, init() between runs,
+ * against a new instance per run
+ */
+void benchmarkReset(const unsigned& runs) {
+    unsigned inst[20];
+    unsigned len = 0u;
+    inst[len++] = encodeI(0x08u, 0u, 1u, 100);    // addi $1, $0, 100
+    inst[len++] = encodeI(0x2Bu, 0u, 1u, 0);      // sw $1, 0($0)
+    inst[len++] = encodeI(0x2Bu, 0u, 1u, 0x7FC);  // sw $1, 0x7FC($0)
+    inst[len++] = encodeI(0x23u, 0u, 2u, 0);      // lw $2, 0($0)
+    while (len < 20u) {
+        inst[len++] = 0xFFFFFFFFu;                // halt, fills the pipeline
+    }
+    unsigned data[16];
+    for (unsigned i = 0; i < 16u; ++i) {
+        data[i] = i;
+    }
+    const lb::InstMemoryModel models[2] = {lb::InstMemoryModel::FLAT, lb::InstMemoryModel::PAGED};
+    const char* names[2][2] = {{"reset flat", "new flat"}, {"reset paged", "new paged"}};
+    for (unsigned m = 0; m < 2u; ++m) {
+        unsigned checksum = 0u;
+        lb::InstSimulatorQuietStats* simulator = new lb::InstSimulatorQuietStats();
+        simulator->setMemoryModel(models[m]);
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < runs; ++i) {
+            simulator->init();
+            simulator->loadImageI(inst, len, 0u);
+            simulator->loadImageD(data, 16u, 0x400u);
+            simulator->simulate();
+            checksum += simulator->getStats().getCycle();
+        }
+        report(names[m][0], runs, "runs", elapsedSeconds(begin), checksum);
+        delete simulator;
+        checksum = 0u;
+        begin = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < runs; ++i) {
+            simulator = new lb::InstSimulatorQuietStats();
+            simulator->setMemoryModel(models[m]);
+            simulator->loadImageI(inst, len, 0u);
+            simulator->loadImageD(data, 16u, 0x400u);
+            simulator->simulate();
+            checksum += simulator->getStats().getCycle();
+            delete simulator;
+        }
+        report(names[m][1], runs, "runs", elapsedSeconds(begin), checksum);
+    }
+    printf("instance size %u bytes\n", static_cast<unsigned>(sizeof(lb::InstSimulatorQuietStats)));
+}
+
+/**
+ * one program on LANES data images, in lockstep on the batch engine
+ * against one functional run per image on a reused instance
+ */
+void benchmarkBatch(const unsigned& iterations) {
+    std::vector<unsigned> inst;
+    inst.push_back(encodeI(0x0Fu, 0u, 1u, static_cast<int>(iterations >> 16)));    // lui $1, hi
+    inst.push_back(encodeI(0x0Du, 1u, 1u, static_cast<int>(iterations & 0xFFFFu))); // ori $1, $1, lo
+    inst.push_back(encodeI(0x23u, 0u, 2u, 0));     // loop: lw $2, 0($0)
+    inst.push_back(0x00621821u);                   // addu $3, $3, $2
+    inst.push_back(0x00622026u);                   // xor $4, $3, $2
+    inst.push_back(encodeI(0x2Bu, 0u, 4u, 0));     // sw $4, 0($0)
+    inst.push_back(encodeI(0x08u, 1u, 1u, -1));    // addi $1, $1, -1
+    inst.push_back(encodeI(0x05u, 1u, 0u, -6));    // bne $1, $0, loop
+    inst.push_back(0xFFFFFFFFu);                   // halt
+    const unsigned lanes = lb::InstBatchSimulator::LANES;
+    std::vector<unsigned> data(lanes * 16u);
+    unsigned state = 2463534242u;
+    for (unsigned& word : data) {
+        word = nextRandom(state);
+    }
+    const unsigned long long count = 6ull * iterations * lanes;
+    lb::InstSimulatorQuiet* functional = new lb::InstSimulatorQuiet();
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (unsigned l = 0; l < lanes; ++l) {
+        functional->init();
+        functional->loadImageI(inst.data(), static_cast<unsigned>(inst.size()), 0u);
+        functional->loadImageD(data.data() + l * 16u, 16u, 0x400u);
+        functional->simulateFunctional();
+    }
+    report("functional", count, "insts", elapsedSeconds(begin), 0u);
+    delete functional;
+    lb::InstBatchSimulator* batch = new lb::InstBatchSimulator();
+    begin = std::chrono::steady_clock::now();
+    batch->loadImageI(std::vector<unsigned>(inst), 0u);
+    for (unsigned l = 0; l < lanes; ++l) {
+        batch->addLane(data.data() + l * 16u, 16u, 0x400u, nullptr, nullptr);
+    }
+    batch->simulate();
+    report("batch", count, "insts", elapsedSeconds(begin), batch->getSplitCount());
+    delete batch;
+}
+
+void usage(const char* name) {
+    fprintf(stderr, "Usage: %s decode [count]\n", name);
+    fprintf(stderr, "       %s memory [iterations]\n", name);
+    fprintf(stderr, "       %s startup [words]\n", name);
+    fprintf(stderr, "       %s reset [runs]\n", name);
+    fprintf(stderr, "       %s batch [iterations]\n", name);
+    exit(EXIT_FAILURE);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+    }
+    const std::string target = argv[1];
+    if (target == "decode") {
+        const unsigned long long count = (argc > 2) ? strtoull(argv[2], nullptr, 10) : 100000000ull;
+        benchmarkDecode(count);
+    }
+    else if (target == "memory") {
+        const unsigned iterations = (argc > 2) ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : 1000000u;
+        benchmarkMemory(iterations);
+    }
+    else if (target == "startup") {
+        const unsigned words = (argc > 2) ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : 16777216u;
+        benchmarkStartup(words);
+    }
+    else if (target == "reset") {
+        const unsigned runs = (argc > 2) ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : 1000000u;
+        benchmarkReset(runs);
+    }
+    else if (target == "batch") {
+        const unsigned iterations = (argc > 2) ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : 1000000u;
+        benchmarkBatch(iterations);
+    }
+    else {
+        usage(argv[0]);
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * InstCheckpoint.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstCheckpoint.h"
+
+namespace lb {
+
+constexpr unsigned InstCheckpoint::MAGIC;
+constexpr unsigned InstCheckpoint::VERSION;
+constexpr unsigned InstCheckpoint::TAG_SIMULATOR;
+constexpr unsigned InstCheckpoint::TAG_MEMORY;
+constexpr unsigned InstCheckpoint::TAG_DECODE;
+constexpr unsigned InstCheckpoint::TAG_PIPELINE;
+constexpr unsigned InstCheckpoint::TAG_END;
+
+InstCheckpoint::InstCheckpoint() {
+    this->fp = nullptr;
+    this->error = false;
+}
+
+InstCheckpoint::~InstCheckpoint() {
+    if (fp) {
+        fclose(fp);
+    }
+}
+
+bool InstCheckpoint::openWrite(const std::string& filePath) {
+    this->filePath = filePath;
+    this->error = false;
+    fp = fopen(filePath.c_str(), "wb");
+    if (!fp) {
+        fail(strerror(errno));
+        return false;
+    }
+    writeWord(MAGIC);
+    writeWord(VERSION);
+    return !error;
+}
+
+bool InstCheckpoint::openRead(const std::string& filePath) {
+    this->filePath = filePath;
+    this->error = false;
+    fp = fopen(filePath.c_str(), "rb");
+    if (!fp) {
+        fail(strerror(errno));
+        return false;
+    }
+    if (readWord() != MAGIC && !error) {
+        fail("not a checkpoint");
+    }
+    if (error) {
+        return false;
+    }
+    const unsigned version = readWord();
+    if (!error && version != VERSION) {
+        fail("unsupported checkpoint version");
+    }
+    return !error;
+}
+
+bool InstCheckpoint::close() {
+    if (fp) {
+        if (fclose(fp) != 0) {
+            fail(strerror(errno));
+        }
+        fp = nullptr;
+    }
+    return !error;
+}
+
+bool InstCheckpoint::good() const {
+    return !error;
+}
+
+void InstCheckpoint::writeWord(const unsigned& word) {
+    writeWords(&word, 1u);
+}
+
+void InstCheckpoint::writeWords(const unsigned* src, const unsigned& len) {
+    unsigned char buffer[256];
+    for (unsigned i = 0; i < len && !error;) {
+        unsigned n = 0u;
+        for (; n < sizeof(buffer) / 4u && i < len; ++n, ++i) {
+            buffer[n * 4u] = static_cast<unsigned char>(src[i] >> 24);
+            buffer[n * 4u + 1u] = static_cast<unsigned char>(src[i] >> 16);
+            buffer[n * 4u + 2u] = static_cast<unsigned char>(src[i] >> 8);
+            buffer[n * 4u + 3u] = static_cast<unsigned char>(src[i]);
+        }
+        if (fwrite(buffer, 4u, n, fp) != n) {
+            fail(strerror(errno));
+        }
+    }
+}
+
+unsigned InstCheckpoint::readWord() {
+    unsigned word = 0u;
+    readWords(&word, 1u);
+    return word;
+}
+
+void InstCheckpoint::readWords(unsigned* dst, const unsigned& len) {
+    unsigned char buffer[256];
+    for (unsigned i = 0; i < len;) {
+        unsigned n = (len - i < sizeof(buffer) / 4u) ? len - i : sizeof(buffer) / 4u;
+        if (error || fread(buffer, 4u, n, fp) != n) {
+            if (!error) {
+                fail("truncated checkpoint");
+            }
+            memset(dst + i, 0, sizeof(unsigned) * (len - i));
+            return;
+        }
+        for (unsigned j = 0; j < n; ++j, ++i) {
+            dst[i] = (static_cast<unsigned>(buffer[j * 4u]) << 24) | (static_cast<unsigned>(buffer[j * 4u + 1u]) << 16) |
+                     (static_cast<unsigned>(buffer[j * 4u + 2u]) << 8) | buffer[j * 4u + 3u];
+        }
+    }
+}
+
+void InstCheckpoint::expect(const unsigned& tag) {
+    if (readWord() != tag && !error) {
+        fail("corrupted checkpoint");
+    }
+}
+
+void InstCheckpoint::fail(const char* reason) {
+    fprintf(stderr, "%s: %s\n", filePath.c_str(), reason);
+    error = true;
+}
+
+} /* namespace lb */
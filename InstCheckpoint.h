@@ -0,0 +1,94 @@
+/*
+ * InstCheckpoint.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTCHECKPOINT_H_
+#define INSTCHECKPOINT_H_
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <string>
+
+namespace lb {
+
+/**
+ * simulator checkpoint file by using C I/O,
+ * big-endian 32-bit words like iimage.bin and dimage.bin,
+ * starts with magic "LBCK" and format version,
+ * each section starts with a tag word checked on read.
+ * a failed read, write or tag check makes the checkpoint bad,
+ * later calls do nothing and reads return 0
+ */
+class InstCheckpoint {
+public:
+    constexpr static unsigned MAGIC = 0x4C42434Bu;
+    constexpr static unsigned VERSION = 2u;
+
+    // section tags
+    constexpr static unsigned TAG_SIMULATOR = 0x53494D55u;
+    constexpr static unsigned TAG_MEMORY = 0x4D454D4Fu;
+    constexpr static unsigned TAG_DECODE = 0x4445434Fu;
+    constexpr static unsigned TAG_PIPELINE = 0x50495045u;
+    constexpr static unsigned TAG_END = 0x454E4421u;
+
+public:
+    InstCheckpoint();
+
+    InstCheckpoint(const InstCheckpoint& that) = delete;
+
+    virtual ~InstCheckpoint();
+
+    InstCheckpoint& operator=(const InstCheckpoint& that) = delete;
+
+    /**
+     * create filePath and write the header
+     * @return false if the file can't be created
+     */
+    bool openWrite(const std::string& filePath);
+
+    /**
+     * open filePath and check the header
+     * @return false if the file can't be opened, or is not a checkpoint of this version
+     */
+    bool openRead(const std::string& filePath);
+
+    /**
+     * close the file, flushes on write
+     * @return false if the checkpoint went bad
+     */
+    bool close();
+
+    bool good() const;
+
+    void writeWord(const unsigned& word);
+
+    void writeWords(const unsigned* src, const unsigned& len);
+
+    unsigned readWord();
+
+    void readWords(unsigned* dst, const unsigned& len);
+
+    /**
+     * read a section tag, bad if it is not tag
+     * @param tag expected tag
+     */
+    void expect(const unsigned& tag);
+
+    /**
+     * report reason and make the checkpoint bad
+     */
+    void fail(const char* reason);
+
+private:
+    FILE* fp;
+    std::string filePath;
+    bool error;
+};
+
+} /* namespace lb */
+
+#endif /* INSTCHECKPOINT_H_ */
@@ -0,0 +1,178 @@
+/*
+ * InstCoSimulator.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstCoSimulator.h"
+#include "InstAllocCounter.h"
+#include "InstDecoder.h"
+
+namespace lb {
+
+constexpr unsigned InstCoSimulator::LOG_SIZE;
+constexpr unsigned InstCoSimulator::MESSAGE_SIZE;
+constexpr unsigned InstCoSimulator::NO_STORE;
+
+InstCoSimulator::InstCoSimulator() :
+        functional(memory, decodeCache) {
+    init();
+}
+
+InstCoSimulator::~InstCoSimulator() {
+
+}
+
+void InstCoSimulator::init() {
+    memory.init();
+    decodeCache.init();
+    functional.init();
+    pcOriginal = 0u;
+    lastPc = 0u;
+    lastCycle = 0u;
+    recentStore[0] = NO_STORE;
+    recentStore[1] = NO_STORE;
+    recentStore[2] = NO_STORE;
+    checking = false;
+    diverged = false;
+    message[0] = '\0';
+    logLen = 0u;
+}
+
+void InstCoSimulator::setMemoryModel(const InstMemoryModel& model) {
+    memory.setModel(model);
+    const bool unified = (model == InstMemoryModel::UNIFIED);
+    memory.setDecodeCache(unified ? &decodeCache : nullptr);
+    decodeCache.setMemory(unified ? &memory : nullptr);
+}
+
+void InstCoSimulator::loadImageI(const unsigned* src, const unsigned& len, const unsigned& pc) {
+    pcOriginal = pc;
+    if (memory.getModel() == InstMemoryModel::UNIFIED) {
+        memory.loadMemory(src, len, pc);
+        decodeCache.init();
+    }
+    else {
+        decodeCache.load(src, len, pc);
+    }
+    functional.init();
+}
+
+void InstCoSimulator::loadImageD(const unsigned* src, const unsigned& len, const unsigned& sp) {
+    // $sp -> $29
+    memory.setRegister(29, sp, InstSize::WORD);
+    memory.loadMemory(src, len);
+}
+
+void InstCoSimulator::start() {
+    functional.init();
+    functional.setPc(pcOriginal);
+    lastPc = pcOriginal;
+    lastCycle = 0u;
+    recentStore[0] = NO_STORE;
+    recentStore[1] = NO_STORE;
+    recentStore[2] = NO_STORE;
+    checking = !diverged;
+    logLen = 0u;
+}
+
+void InstCoSimulator::flush() {
+    for (unsigned i = 0u; i < logLen; ++i) {
+        if (!check(log[i])) {
+            break;
+        }
+    }
+    logLen = 0u;
+}
+
+bool InstCoSimulator::hasDiverged() const {
+    return diverged;
+}
+
+void InstCoSimulator::report(FILE* fp) const {
+    if (diverged) {
+        fprintf(fp, "%s\n", message);
+    }
+}
+
+bool InstCoSimulator::check(const InstRetired& retired) {
+    if (!checking) {
+        return false;
+    }
+    char detail[MESSAGE_SIZE];
+    if (functional.getPc() != retired.pc) {
+        skipNOP(retired.pc, retired.cycle - lastCycle);
+        if (functional.getPc() != retired.pc) {
+            // a wrong branch or jump retired before, it writes nothing
+            snprintf(detail, MESSAGE_SIZE, "expected pc 0x%08X after 0x%08X", functional.getPc(), lastPc);
+            return diverge(retired, detail);
+        }
+    }
+    // a store to code only marks the entry, inst stays valid over step()
+    const InstDataBin* inst = &decodeCache.fetch(retired.pc);
+    if (inst->getInst() != retired.inst) {
+        // the three instructions behind a store are fetched before it writes in DM
+        if (retired.pc != recentStore[0] && retired.pc != recentStore[1] && retired.pc != recentStore[2]) {
+            snprintf(detail, MESSAGE_SIZE, "expected instruction 0x%08X", inst->getInst());
+            return diverge(retired, detail);
+        }
+        // rare, self-modifying code only
+        InstAllocCounter::Expected expected;
+        stale = InstDecoder::decodeInstBin(retired.inst);
+        inst = &stale;
+    }
+    lastPc = retired.pc;
+    lastCycle = retired.cycle;
+    recentStore[2] = recentStore[1];
+    recentStore[1] = recentStore[0];
+    recentStore[0] = inst->isClass(InstClass::STORE) ? retired.addr : NO_STORE;
+    if (!functional.step(*inst)) {
+        if (!functional.isAlive()) {
+            return diverge(retired, "expected a memory error");
+        }
+        // halted, nothing retires after the halt
+        checking = false;
+        return false;
+    }
+    if (inst->isClass(InstClass::STORE)) {
+        const unsigned expected = memory.getMemory(retired.addr, InstSize::WORD);
+        if (retired.val != expected) {
+            snprintf(detail, MESSAGE_SIZE, "memory 0x%08X = 0x%08X, expected 0x%08X",
+                     retired.addr, retired.val, expected);
+            return diverge(retired, detail);
+        }
+    }
+    // no mask for $0, both sides keep it 0
+    else if (inst->getRegWriteMask()) {
+        const unsigned reg = inst->getRegWrite().at(0).val;
+        if (retired.val != memory.getRegister(reg)) {
+            snprintf(detail, MESSAGE_SIZE, "$%02u = 0x%08X, expected 0x%08X",
+                     reg, retired.val, memory.getRegister(reg));
+            return diverge(retired, detail);
+        }
+    }
+    return true;
+}
+
+void InstCoSimulator::skipNOP(const unsigned& pc, unsigned maxInst) {
+    for (; maxInst && functional.getPc() != pc; --maxInst) {
+        if (!decodeCache.fetch(functional.getPc()).isClass(InstClass::NOP)) {
+            return;
+        }
+        functional.step();
+    }
+}
+
+bool InstCoSimulator::diverge(const InstRetired& retired, const char* detail) {
+    // once per run
+    InstAllocCounter::Expected expected;
+    InstDataBin inst = InstDecoder::decodeInstBin(retired.inst);
+    snprintf(message, MESSAGE_SIZE, "co-simulation: cycle %u, 0x%08X %s at pc 0x%08X: %s",
+             retired.cycle, retired.inst, inst.getInstName(), retired.pc, detail);
+    checking = false;
+    diverged = true;
+    return false;
+}
+
+} /* namespace lb */
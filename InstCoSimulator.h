@@ -0,0 +1,165 @@
+/*
+ * InstCoSimulator.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTCOSIMULATOR_H_
+#define INSTCOSIMULATOR_H_
+
+#include <cstdio>
+#include "InstDataBin.h"
+#include "InstDecodeCache.h"
+#include "InstFunctionalSimulator.h"
+#include "InstMemory.h"
+#include "InstPipelineData.h"
+#include "InstType.h"
+
+namespace lb {
+
+/**
+ * lockstep co-simulation checker,
+ * a functional reference with its own registers and memory steps over every instruction
+ * the pipeline retires, nop excluded, and the register and memory words written are compared.
+ * retirements are logged and checked LOG_SIZE at a time, the pipeline and the reference
+ * each stay hot in cache for a while, the first divergence is kept, checking stops there
+ * or once the reference halts
+ */
+class InstCoSimulator {
+public:
+    constexpr static unsigned LOG_SIZE = 256u;
+
+public:
+    InstCoSimulator();
+
+    InstCoSimulator(const InstCoSimulator& that) = delete;
+
+    virtual ~InstCoSimulator();
+
+    InstCoSimulator& operator=(const InstCoSimulator& that) = delete;
+
+    /**
+     * reset reference state and divergence, keeps the memory model
+     */
+    void init();
+
+    /**
+     * same as the pipeline, call before loadImageI, loadImageD
+     */
+    void setMemoryModel(const InstMemoryModel& model);
+
+    void loadImageI(const unsigned* src, const unsigned& len, const unsigned& pc);
+
+    void loadImageD(const unsigned* src, const unsigned& len, const unsigned& sp);
+
+    /**
+     * reference starts at the first instruction, with the loaded images
+     */
+    void start();
+
+    /**
+     * an instruction retired, log the register or memory word it wrote
+     * @param retired latch of the retired instruction, after write back
+     * @param memory pipeline registers and memory
+     * @param cycle cycle of the write back
+     */
+    void retire(const InstPipelineData& retired, InstMemory& memory, const unsigned& cycle);
+
+    /**
+     * check the logged retirements, call once the pipeline stops
+     */
+    void flush();
+
+    bool hasDiverged() const;
+
+    /**
+     * print the first divergence, nothing if there is none
+     */
+    void report(FILE* fp) const;
+
+private:
+    constexpr static unsigned MESSAGE_SIZE = 160u;
+    // never a word address
+    constexpr static unsigned NO_STORE = 0xFFFFFFFFu;
+
+private:
+    /**
+     * inst: instruction word, val: register written or word stored at addr
+     */
+    struct InstRetired {
+        unsigned cycle;
+        unsigned pc;
+        unsigned inst;
+        unsigned addr;
+        unsigned val;
+    };
+
+private:
+    InstMemory memory;
+    InstDecodeCache decodeCache;
+    InstFunctionalSimulator functional;
+    unsigned pcOriginal;
+    // pc and cycle of the last instruction checked
+    unsigned lastPc;
+    unsigned lastCycle;
+    // words stored by the last three instructions checked, newest first
+    unsigned recentStore[3];
+    // decoded stale instruction, executed in place of the rewritten one
+    InstDataBin stale;
+    // checking, false before start(), after a divergence or the reference halt
+    bool checking;
+    bool diverged;
+    char message[MESSAGE_SIZE];
+    unsigned logLen;
+    InstRetired log[LOG_SIZE];
+
+private:
+    /**
+     * step the reference over one logged retirement and compare
+     * @return false at the first divergence or the halt
+     */
+    bool check(const InstRetired& retired);
+
+    /**
+     * step the reference over nop, the pipeline retires none,
+     * at most one per cycle since the last retirement, a nop sled never ends otherwise
+     * @param pc pc of the instruction retiring
+     * @param maxInst nop the pipeline may have fetched meanwhile
+     */
+    void skipNOP(const unsigned& pc, unsigned maxInst);
+
+    /**
+     * keep the first divergence
+     * @param detail what differs
+     * @return false
+     */
+    bool diverge(const InstRetired& retired, const char* detail);
+};
+
+// on every retirement, values only, the reference runs in flush()
+inline void InstCoSimulator::retire(const InstPipelineData& retired, InstMemory& memory, const unsigned& cycle) {
+    if (!checking) {
+        return;
+    }
+    const InstDataBin& inst = retired.getInst();
+    InstRetired& entry = log[logLen];
+    entry.cycle = cycle;
+    entry.pc = retired.getInstPc();
+    entry.inst = inst.getInst();
+    if (inst.isClass(InstClass::STORE)) {
+        // the store succeeded, its word is aligned and in range
+        entry.addr = retired.getALUOut() & ~3u;
+        entry.val = memory.getMemory(entry.addr, InstSize::WORD);
+    }
+    else if (inst.getRegWriteMask()) {
+        entry.val = memory.getRegister(inst.getRegWrite().at(0).val);
+    }
+    if (++logLen == LOG_SIZE) {
+        flush();
+    }
+}
+
+} /* namespace lb */
+
+#endif /* INSTCOSIMULATOR_H_ */
@@ -0,0 +1,360 @@
+/*
+ * InstCycleTrace.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstCycleTrace.h"
+#include "InstAllocCounter.h"
+#include "InstDecoder.h"
+
+namespace lb {
+
+constexpr unsigned InstCycleTrace::MAGIC;
+constexpr unsigned InstCycleTrace::VERSION;
+constexpr unsigned char InstCycleTrace::FLAG_FLUSH;
+constexpr unsigned char InstCycleTrace::FLAG_STALL;
+constexpr unsigned char InstCycleTrace::FLAG_HELD;
+constexpr unsigned char InstCycleTrace::FLAG_SHIFT;
+constexpr unsigned char InstCycleTrace::FLAG_PC;
+constexpr unsigned char InstCycleTrace::FLAG_REG;
+constexpr unsigned char InstCycleTrace::FLAG_FWD;
+constexpr unsigned char InstCycleTrace::FLAG_CYCLE;
+constexpr unsigned InstCycleTrace::MAX_RECORD;
+
+InstCycleTrace::InstCycleTrace() {
+    init();
+}
+
+InstCycleTrace::~InstCycleTrace() {
+
+}
+
+void InstCycleTrace::init() {
+    started = false;
+    cycle = 0u;
+    pc = 0u;
+    for (unsigned i = 0; i < 32u; ++i) {
+        reg[i] = 0u;
+    }
+    // latches start as nop
+    const InstDataBin nop = InstDecoder::decodeInstBin(0u);
+    for (unsigned i = 0; i < InstPipeline::STAGES; ++i) {
+        inst[i] = opKey(nop);
+        stage[i] = nop;
+    }
+    opIndex.clear();
+    ops.clear();
+    flags = 0u;
+    idForward = InstElementList<2>();
+    exForward = InstElementList<2>();
+}
+
+void InstCycleTrace::write(FILE* fp, const unsigned& cycle, const InstMemory& memory, const unsigned& pc,
+                           const InstPipeline& pipeline, const InstElementList<2>& idForward,
+                           const InstElementList<2>& exForward) {
+    unsigned char buffer[MAX_RECORD];
+    unsigned len = 1u;
+    unsigned flags = 0u;
+    if (!started) {
+        len = putWord(buffer, 0u, MAGIC);
+        len = putWord(buffer, len, VERSION);
+        fwrite(buffer, 1u, len, fp);
+        started = true;
+        len = 1u;
+    }
+    const InstPipelineData& fetched = pipeline.at(0u);
+    flags |= fetched.isFlushed() ? FLAG_FLUSH : 0u;
+    flags |= fetched.isStalled() ? FLAG_STALL : 0u;
+    if (cycle != this->cycle) {
+        flags |= FLAG_CYCLE;
+        len = putWord(buffer, len, cycle);
+    }
+    if (pc != this->pc) {
+        flags |= FLAG_PC;
+        len = putWord(buffer, len, pc);
+    }
+    unsigned mask = 0u;
+    for (unsigned i = 0; i < 32u; ++i) {
+        const unsigned val = memory.getRegister(i);
+        if (val != reg[i]) {
+            mask |= 1u << i;
+            reg[i] = val;
+        }
+    }
+    if (mask) {
+        flags |= FLAG_REG;
+        len = putWord(buffer, len, mask);
+        for (unsigned i = 0; i < 32u; ++i) {
+            if (mask & (1u << i)) {
+                len = putWord(buffer, len, reg[i]);
+            }
+        }
+    }
+    unsigned long long key[InstPipeline::STAGES];
+    bool shift = true;
+    for (unsigned i = 0; i < InstPipeline::STAGES; ++i) {
+        key[i] = opKey(pipeline.at(i).getInst());
+        if (i && key[i] != inst[i - 1u]) {
+            shift = false;
+        }
+    }
+    if (shift) {
+        flags |= FLAG_SHIFT;
+        len = putOp(buffer, len, key[0]);
+    }
+    else {
+        for (unsigned i = 0; i < InstPipeline::STAGES; ++i) {
+            len = putOp(buffer, len, key[i]);
+        }
+    }
+    if (!idForward.empty() || !exForward.empty()) {
+        flags |= FLAG_FWD;
+        buffer[len++] = static_cast<unsigned char>(idForward.size() | (exForward.size() << 2));
+        for (const auto& item : idForward) {
+            buffer[len++] = static_cast<unsigned char>(item.val | ((item.type == InstElementType::RS) ? 0u : 0x80u));
+        }
+        for (const auto& item : exForward) {
+            buffer[len++] = static_cast<unsigned char>(item.val | ((item.type == InstElementType::RS) ? 0u : 0x80u));
+        }
+    }
+    buffer[0] = static_cast<unsigned char>(flags);
+    fwrite(buffer, 1u, len, fp);
+    for (unsigned i = 0; i < InstPipeline::STAGES; ++i) {
+        inst[i] = key[i];
+    }
+    this->cycle = cycle + 1u;
+    // pc advances after the snapshot unless IF is stalled
+    this->pc = (flags & FLAG_STALL) ? pc : pc + 4u;
+}
+
+bool InstCycleTrace::writeHeld(FILE* fp, const unsigned& count) {
+    if (!started) {
+        return false;
+    }
+    unsigned char buffer[8];
+    buffer[0] = FLAG_HELD;
+    const unsigned len = putVarint(buffer, 1u, count);
+    fwrite(buffer, 1u, len, fp);
+    cycle += count;
+    return true;
+}
+
+bool InstCycleTrace::render(FILE* in, FILE* out, const char* name) {
+    init();
+    unsigned magic = 0u;
+    unsigned version = 0u;
+    if (!getWord(in, magic) || magic != MAGIC || !getWord(in, version)) {
+        fprintf(stderr, "%s: not a cycle trace\n", name);
+        return false;
+    }
+    if (version != VERSION) {
+        fprintf(stderr, "%s: unsupported cycle trace version\n", name);
+        return false;
+    }
+    started = true;
+    unsigned nextPc = 0u;
+    for (;;) {
+        const int c = getc(in);
+        if (c == EOF) {
+            return true;
+        }
+        const unsigned recordFlags = static_cast<unsigned>(c);
+        if (recordFlags & FLAG_HELD) {
+            unsigned count = 0u;
+            if (!getVarint(in, count)) {
+                break;
+            }
+            for (unsigned i = 0; i < count; ++i) {
+                print(out, cycle + i);
+            }
+            cycle += count;
+            continue;
+        }
+        if ((recordFlags & FLAG_CYCLE) && !getWord(in, cycle)) {
+            break;
+        }
+        pc = nextPc;
+        if ((recordFlags & FLAG_PC) && !getWord(in, pc)) {
+            break;
+        }
+        unsigned mask = 0u;
+        if ((recordFlags & FLAG_REG) && !getWord(in, mask)) {
+            break;
+        }
+        bool good = true;
+        for (unsigned i = 0; i < 32u && good; ++i) {
+            if (mask & (1u << i)) {
+                good = getWord(in, reg[i]);
+            }
+        }
+        const unsigned opCount = (recordFlags & FLAG_SHIFT) ? 1u : InstPipeline::STAGES;
+        if (recordFlags & FLAG_SHIFT) {
+            for (unsigned i = InstPipeline::STAGES - 1u; i > 0u; --i) {
+                stage[i] = stage[i - 1u];
+            }
+        }
+        for (unsigned i = 0; i < opCount && good; ++i) {
+            unsigned op = 0u;
+            good = getVarint(in, op);
+            if (good && op == 0u) {
+                unsigned word = 0u;
+                unsigned nameId = 0u;
+                good = getWord(in, word) && getByte(in, nameId);
+                InstDataBin bin = InstDecoder::decodeInstBin(word);
+                if (bin.getInstNameId() != nameId) {
+                    // undefined opcode, the latch holds an empty micro-op
+                    bin = InstDataBin();
+                    bin.setInst(word);
+                }
+                ops.push_back(bin);
+                op = static_cast<unsigned>(ops.size());
+            }
+            if (good && op > ops.size()) {
+                fprintf(stderr, "%s: corrupted cycle trace\n", name);
+                return false;
+            }
+            if (good) {
+                stage[i] = ops[op - 1u];
+            }
+        }
+        idForward = InstElementList<2>();
+        exForward = InstElementList<2>();
+        if (good && (recordFlags & FLAG_FWD)) {
+            unsigned count = 0u;
+            good = getByte(in, count);
+            for (unsigned i = 0; i < (count & 0x3u) + (count >> 2) && good; ++i) {
+                unsigned item = 0u;
+                good = getByte(in, item);
+                const InstElement element(item & 0x1Fu, (item & 0x80u) ? InstElementType::RT : InstElementType::RS);
+                if (i < (count & 0x3u)) {
+                    idForward.push_back(element);
+                }
+                else {
+                    exForward.push_back(element);
+                }
+            }
+        }
+        if (!good) {
+            break;
+        }
+        flags = recordFlags;
+        print(out, cycle);
+        ++cycle;
+        // held cycles show the pc of this record
+        nextPc = (flags & FLAG_STALL) ? pc : pc + 4u;
+    }
+    fprintf(stderr, "%s: truncated cycle trace\n", name);
+    return false;
+}
+
+unsigned InstCycleTrace::putOp(unsigned char* buffer, unsigned len, const unsigned long long& key) {
+    const auto it = opIndex.find(key);
+    if (it != opIndex.end()) {
+        return putVarint(buffer, len, it->second + 1u);
+    }
+    {
+        // once per distinct micro-op
+        InstAllocCounter::Expected expected;
+        const unsigned op = static_cast<unsigned>(opIndex.size());
+        opIndex[key] = op;
+    }
+    len = putVarint(buffer, len, 0u);
+    len = putWord(buffer, len, static_cast<unsigned>(key));
+    buffer[len++] = static_cast<unsigned char>(key >> 32);
+    return len;
+}
+
+unsigned long long InstCycleTrace::opKey(const InstDataBin& inst) {
+    return (static_cast<unsigned long long>(inst.getInstNameId()) << 32) | inst.getInst();
+}
+
+void InstCycleTrace::print(FILE* out, const unsigned& cycle) const {
+    // same text as InstSimulator::dumpSnapshot()
+    fprintf(out, "cycle %u\n", cycle);
+    for (unsigned i = 0; i < 32; ++i) {
+        fprintf(out, "$%02d: 0x%08X\n", i, reg[i]);
+    }
+    fprintf(out, "PC: 0x%08X\n", pc);
+    fprintf(out, "IF: 0x%08X", stage[0].getInst());
+    if (flags & FLAG_FLUSH) {
+        fprintf(out, " to_be_flushed");
+    }
+    else if (flags & FLAG_STALL) {
+        fprintf(out, " to_be_stalled");
+    }
+    fprintf(out, "\n");
+    fprintf(out, "ID: %s", stage[1].getInstName());
+    if (flags & FLAG_STALL) {
+        fprintf(out, " to_be_stalled");
+    }
+    else {
+        printForward(out, idForward);
+    }
+    fprintf(out, "\n");
+    fprintf(out, "EX: %s", stage[2].getInstName());
+    printForward(out, exForward);
+    fprintf(out, "\n");
+    fprintf(out, "DM: %s\n", stage[3].getInstName());
+    fprintf(out, "WB: %s\n", stage[4].getInstName());
+    fprintf(out, "\n\n");
+}
+
+void InstCycleTrace::printForward(FILE* out, const InstElementList<2>& forward) {
+    for (const auto& item : forward) {
+        fprintf(out, " fwd_EX-DM_%s_$%d", (item.type == InstElementType::RS) ? "rs" : "rt", item.val);
+    }
+}
+
+unsigned InstCycleTrace::putWord(unsigned char* buffer, unsigned len, const unsigned& word) {
+    buffer[len++] = static_cast<unsigned char>(word >> 24);
+    buffer[len++] = static_cast<unsigned char>(word >> 16);
+    buffer[len++] = static_cast<unsigned char>(word >> 8);
+    buffer[len++] = static_cast<unsigned char>(word);
+    return len;
+}
+
+unsigned InstCycleTrace::putVarint(unsigned char* buffer, unsigned len, unsigned val) {
+    while (val >= 0x80u) {
+        buffer[len++] = static_cast<unsigned char>((val & 0x7Fu) | 0x80u);
+        val >>= 7;
+    }
+    buffer[len++] = static_cast<unsigned char>(val);
+    return len;
+}
+
+bool InstCycleTrace::getByte(FILE* in, unsigned& byte) {
+    const int c = getc(in);
+    byte = static_cast<unsigned>(c);
+    return c != EOF;
+}
+
+bool InstCycleTrace::getWord(FILE* in, unsigned& word) {
+    word = 0u;
+    for (unsigned i = 0; i < 4u; ++i) {
+        unsigned byte = 0u;
+        if (!getByte(in, byte)) {
+            return false;
+        }
+        word = (word << 8) | byte;
+    }
+    return true;
+}
+
+bool InstCycleTrace::getVarint(FILE* in, unsigned& val) {
+    val = 0u;
+    for (unsigned shift = 0u; shift < 32u; shift += 7u) {
+        unsigned byte = 0u;
+        if (!getByte(in, byte)) {
+            return false;
+        }
+        val |= (byte & 0x7Fu) << shift;
+        if (!(byte & 0x80u)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} /* namespace lb */
@@ -0,0 +1,139 @@
+/*
+ * InstCycleTrace.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTCYCLETRACE_H_
+#define INSTCYCLETRACE_H_
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+#include "InstDataBin.h"
+#include "InstMemory.h"
+#include "InstPipeline.h"
+#include "InstType.h"
+
+namespace lb {
+
+/**
+ * binary per-cycle snapshot, the same content as snapshot.rpt in a few bytes a cycle,
+ * render() writes the snapshot.rpt text back from it.
+ * starts with magic "LBCY" and format version as big-endian words,
+ * then one record per cycle, a flag byte followed by what changed since the last record:
+ * the cycle and pc words unless they follow from it, a changed register bitmask and values,
+ * the micro-op ids of the five latches, or only of IF when the others moved on by one stage,
+ * and the forwarded registers of ID and EX.
+ * a micro-op id is a 7-bit varint, 0 then the instruction word and name id on its first use,
+ * the name id tells an undefined opcode, held as word 0, from a nop.
+ * the cycles a memory access holds are one record with their count
+ */
+class InstCycleTrace {
+public:
+    constexpr static unsigned MAGIC = 0x4C424359u;
+    constexpr static unsigned VERSION = 2u;
+
+public:
+    InstCycleTrace();
+
+    InstCycleTrace(const InstCycleTrace& that) = delete;
+
+    virtual ~InstCycleTrace();
+
+    InstCycleTrace& operator=(const InstCycleTrace& that) = delete;
+
+    /**
+     * forget the last record, the next one writes the header first
+     */
+    void init();
+
+    /**
+     * append the snapshot of a cycle
+     * @param fp file open for binary write
+     * @param cycle cycle number
+     * @param memory registers
+     * @param pc pc shown
+     * @param pipeline latches with their stall and flush flags, ID is stalled with IF
+     * @param idForward registers forwarded to ID
+     * @param exForward registers forwarded to EX
+     */
+    void write(FILE* fp, const unsigned& cycle, const InstMemory& memory, const unsigned& pc,
+               const InstPipeline& pipeline, const InstElementList<2>& idForward,
+               const InstElementList<2>& exForward);
+
+    /**
+     * append count held cycles, the last snapshot repeated with the next cycle numbers
+     * @return false if there is no last snapshot to repeat, nothing is written
+     */
+    bool writeHeld(FILE* fp, const unsigned& count);
+
+    /**
+     * write snapshot.rpt text of a trace
+     * @param in file open for binary read, at its start
+     * @param out text output
+     * @param name file name of in for messages
+     * @return false if in is not a cycle trace or is cut short
+     */
+    bool render(FILE* in, FILE* out, const char* name);
+
+private:
+    // record flags
+    constexpr static unsigned char FLAG_FLUSH = 0x01u;
+    constexpr static unsigned char FLAG_STALL = 0x02u;
+    constexpr static unsigned char FLAG_HELD = 0x04u;
+    constexpr static unsigned char FLAG_SHIFT = 0x08u;
+    constexpr static unsigned char FLAG_PC = 0x10u;
+    constexpr static unsigned char FLAG_REG = 0x20u;
+    constexpr static unsigned char FLAG_FWD = 0x40u;
+    constexpr static unsigned char FLAG_CYCLE = 0x80u;
+    // flags, cycle, pc, mask, 32 registers, 5 ops of up to 10 bytes, forward count and 4 registers
+    constexpr static unsigned MAX_RECORD = 256u;
+
+private:
+    bool started;
+    // write: cycle and pc of the next record unless it carries its own
+    // render: cycle of the next record, pc of the last one
+    unsigned cycle;
+    unsigned pc;
+    unsigned reg[32];
+    // write: opKey() of the latches in the last record, opKey() -> micro-op id
+    unsigned long long inst[InstPipeline::STAGES];
+    std::unordered_map<unsigned long long, unsigned> opIndex;
+    // render: decoded micro-ops by id, latches, flags and forwarded registers of the last record
+    std::vector<InstDataBin> ops;
+    InstDataBin stage[InstPipeline::STAGES];
+    unsigned flags;
+    InstElementList<2> idForward;
+    InstElementList<2> exForward;
+
+private:
+    unsigned putOp(unsigned char* buffer, unsigned len, const unsigned long long& key);
+
+    /**
+     * name id and instruction word, what snapshot.rpt shows of a latch
+     */
+    static unsigned long long opKey(const InstDataBin& inst);
+
+    /**
+     * snapshot.rpt text of the last record
+     */
+    void print(FILE* out, const unsigned& cycle) const;
+
+    static void printForward(FILE* out, const InstElementList<2>& forward);
+
+    static unsigned putWord(unsigned char* buffer, unsigned len, const unsigned& word);
+
+    static unsigned putVarint(unsigned char* buffer, unsigned len, unsigned val);
+
+    static bool getByte(FILE* in, unsigned& byte);
+
+    static bool getWord(FILE* in, unsigned& word);
+
+    static bool getVarint(FILE* in, unsigned& val);
+};
+
+} /* namespace lb */
+
+#endif /* INSTCYCLETRACE_H_ */
@@ -18,12 +18,11 @@ InstDataBin::InstDataBin() {
     this->c = 0u;
     this->funct = 0u;
     this->inst = 0u;
-    this->regRead.clear();
-    this->regWrite.clear();
-}
-
-InstDataBin::~InstDataBin() {
-
+    this->instNameId = InstLookUp::NAME_UNDEF;
+    this->instClass = static_cast<unsigned char>(InstClass::NOP);
+    this->exOp = InstExOp::NONE;
+    this->dmOp = InstDmOp::NONE;
+    this->wbOp = InstWbOp::NONE;
 }
 
 InstType InstDataBin::getInstType() const {
@@ -58,36 +57,71 @@ unsigned InstDataBin::getInst() const {
     return inst;
 }
 
-std::string InstDataBin::getInstName() const {
-    return instName;
+const char* InstDataBin::getInstName() const {
+    return InstLookUp::instNameLookUp(instNameId);
+}
+
+unsigned InstDataBin::getInstNameId() const {
+    return instNameId;
+}
+
+bool InstDataBin::isClass(const InstClass& val) const {
+    return (instClass & static_cast<unsigned char>(val)) != 0u;
 }
 
-const std::vector<InstElement>& InstDataBin::getRegRead() const {
+unsigned InstDataBin::getExOp() const {
+    return static_cast<unsigned>(exOp);
+}
+
+unsigned InstDataBin::getDmOp() const {
+    return static_cast<unsigned>(dmOp);
+}
+
+unsigned InstDataBin::getWbOp() const {
+    return static_cast<unsigned>(wbOp);
+}
+
+const InstElementList<2>& InstDataBin::getRegRead() const {
     return regRead;
 }
 
-const std::vector<InstElement>& InstDataBin::getRegWrite() const {
+const InstElementList<1>& InstDataBin::getRegWrite() const {
     return regWrite;
 }
 
+unsigned InstDataBin::getRegReadMask() const {
+    unsigned mask = 0u;
+    for (const auto& item : regRead) {
+        mask |= 1u << item.val;
+    }
+    return mask & ~1u;
+}
+
+unsigned InstDataBin::getRegWriteMask() const {
+    if (regWrite.empty()) {
+        return 0u;
+    }
+    return (1u << regWrite.at(0).val) & ~1u;
+}
+
 void InstDataBin::setInstType(const InstType& val) {
     instType = val;
 }
 
 void InstDataBin::setOpCode(const unsigned& val) {
-    opCode = val;
+    opCode = static_cast<unsigned char>(val);
 }
 
 void InstDataBin::setRs(const unsigned& val) {
-    rs = val;
+    rs = static_cast<unsigned char>(val);
 }
 
 void InstDataBin::setRt(const unsigned& val) {
-    rt = val;
+    rt = static_cast<unsigned char>(val);
 }
 
 void InstDataBin::setRd(const unsigned& val) {
-    rd = val;
+    rd = static_cast<unsigned char>(val);
 }
 
 void InstDataBin::setC(const unsigned& val) {
@@ -95,7 +129,7 @@ void InstDataBin::setC(const unsigned& val) {
 }
 
 void InstDataBin::setFunct(const unsigned& val) {
-    funct = val;
+    funct = static_cast<unsigned char>(val);
 }
 
 void InstDataBin::setInst(const unsigned& val) {
@@ -104,21 +138,21 @@ void InstDataBin::setInst(const unsigned& val) {
 
 void InstDataBin::setInstName(const unsigned& val) {
     if (instType == InstType::UNDEF) {
-        instName = "";
+        instNameId = InstLookUp::NAME_UNDEF;
     }
     else if (instType == InstType::R) {
         if (inst == 0u) {
-            instName = "NOP";
+            instNameId = InstLookUp::NAME_NOP;
         }
         else if (rt == 0u && rd == 0u && c == 0u && funct == 0u) {
-            instName = "NOP";
+            instNameId = InstLookUp::NAME_NOP;
         }
         else {
-            instName = toUpperString(InstLookUp::functLookUp(val));
+            instNameId = static_cast<unsigned char>(InstLookUp::functNameId(val));
         }
     }
     else {
-        instName = toUpperString(InstLookUp::opCodeLookUp(val));
+        instNameId = static_cast<unsigned char>(InstLookUp::opCodeNameId(val));
     }
 }
 
@@ -130,4 +164,20 @@ void InstDataBin::setRegWrite(const InstElement& reg) {
     regWrite.push_back(reg);
 }
 
+void InstDataBin::setInstClass(const InstClass& val) {
+    instClass = static_cast<unsigned char>(val);
+}
+
+void InstDataBin::setExOp(const InstExOp& val) {
+    exOp = val;
+}
+
+void InstDataBin::setDmOp(const InstDmOp& val) {
+    dmOp = val;
+}
+
+void InstDataBin::setWbOp(const InstWbOp& val) {
+    wbOp = val;
+}
+
 } /* namespace lb */
@@ -8,20 +8,22 @@
 #ifndef INSTDATABIN_H_
 #define INSTDATABIN_H_
 
-#include <string>
-#include <vector>
+#include <type_traits>
 #include "InstLookUp.h"
 #include "InstUtility.h"
 #include "InstType.h"
 
 namespace lb {
 
+/**
+ * decoded instruction(micro-op), saved by unsigned
+ * trivially copyable and at most 32 bytes,
+ * so no virtual destructor and no heap members
+ */
 class InstDataBin {
 public:
     InstDataBin();
 
-    virtual ~InstDataBin();
-
     InstType getInstType() const;
 
     unsigned getOpCode() const;
@@ -38,11 +40,31 @@ public:
 
     unsigned getInst() const;
 
-    const std::vector<InstElement>& getRegRead() const;
+    const InstElementList<2>& getRegRead() const;
+
+    const InstElementList<1>& getRegWrite() const;
+
+    /**
+     * registers read, one bit per register, $0 excluded
+     */
+    unsigned getRegReadMask() const;
+
+    /**
+     * registers written, one bit per register, $0 excluded
+     */
+    unsigned getRegWriteMask() const;
+
+    const char* getInstName() const;
+
+    unsigned getInstNameId() const;
+
+    bool isClass(const InstClass& val) const;
+
+    unsigned getExOp() const;
 
-    const std::vector<InstElement>& getRegWrite() const;
+    unsigned getDmOp() const;
 
-    std::string getInstName() const;
+    unsigned getWbOp() const;
 
     void setInstType(const InstType& val);
 
@@ -66,20 +88,35 @@ public:
 
     void setRegWrite(const InstElement& reg);
 
+    void setInstClass(const InstClass& val);
+
+    void setExOp(const InstExOp& val);
+
+    void setDmOp(const InstDmOp& val);
+
+    void setWbOp(const InstWbOp& val);
+
 private:
-    InstType instType;
-    unsigned opCode;
-    unsigned rs;
-    unsigned rt;
-    unsigned rd;
-    unsigned c;
-    unsigned funct;
     unsigned inst;
-    std::string instName;
-    std::vector<InstElement> regRead;
-    std::vector<InstElement> regWrite;
+    unsigned c;
+    InstType instType;
+    unsigned char opCode;
+    unsigned char rs;
+    unsigned char rt;
+    unsigned char rd;
+    unsigned char funct;
+    unsigned char instNameId;
+    unsigned char instClass;
+    InstExOp exOp;
+    InstDmOp dmOp;
+    InstWbOp wbOp;
+    InstElementList<2> regRead;
+    InstElementList<1> regWrite;
 };
 
+static_assert(std::is_trivially_copyable<InstDataBin>::value, "InstDataBin must be trivially copyable");
+static_assert(sizeof(InstDataBin) <= 32u, "InstDataBin must fit in 32 bytes");
+
 } /* namespace lb */
 
 #endif /* INSTDATABIN_H_ */
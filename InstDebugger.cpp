@@ -0,0 +1,135 @@
+/*
+ * InstDebugger.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "InstDebugger.h"
+
+namespace lb {
+
+InstDebugger::InstDebugger(InstSimulatorDebug& simulator, const unsigned& interval, const unsigned& depth) :
+        simulator(simulator) {
+    simulator.startDebug(interval, depth);
+}
+
+InstDebugger::~InstDebugger() {
+
+}
+
+void InstDebugger::run(FILE* in, FILE* out) {
+    const bool prompt = isatty(fileno(in));
+    char line[256];
+    while (true) {
+        if (prompt) {
+            fprintf(out, "(lb) ");
+            fflush(out);
+        }
+        if (!fgets(line, sizeof(line), in) || !execute(line, out)) {
+            break;
+        }
+        fflush(out);
+    }
+}
+
+bool InstDebugger::execute(const char* line, FILE* out) {
+    char command[16] = "";
+    char arg[64] = "";
+    if (sscanf(line, "%15s %63s", command, arg) < 1) {
+        return true;
+    }
+    char* end = nullptr;
+    unsigned long val = strtoul(arg, &end, 0);
+    const bool hasVal = (end != arg && !*end);
+    if (!strcmp(command, "q") || !strcmp(command, "quit")) {
+        return false;
+    }
+    else if (!strcmp(command, "s") || !strcmp(command, "step")) {
+        const unsigned count = hasVal ? static_cast<unsigned>(val) : 1u;
+        for (unsigned i = 0; i < count && simulator.step(); ++i) {
+        }
+    }
+    else if (!strcmp(command, "b") || !strcmp(command, "back")) {
+        const unsigned count = hasVal ? static_cast<unsigned>(val) : 1u;
+        const unsigned cycle = simulator.getCycle();
+        simulator.gotoCycle(cycle > count ? cycle - count : 0u);
+    }
+    else if ((!strcmp(command, "g") || !strcmp(command, "goto")) && hasVal) {
+        // cycle N is printed after N + 1 cycles
+        simulator.gotoCycle(static_cast<unsigned>(val) + 1u);
+    }
+    else if (!strcmp(command, "c") || !strcmp(command, "continue")) {
+        while (simulator.step()) {
+        }
+    }
+    else if ((!strcmp(command, "l") || !strcmp(command, "last")) && arg[0] == '$') {
+        val = strtoul(arg + 1, &end, 10);
+        if (end == arg + 1 || *end || val > 31u) {
+            fprintf(out, "bad register %s\n", arg);
+            return true;
+        }
+        if (!simulator.findLastRegWrite(static_cast<unsigned>(val))) {
+            fprintf(out, "no earlier write to %s\n", arg);
+            return true;
+        }
+    }
+    else if ((!strcmp(command, "l") || !strcmp(command, "last")) && hasVal) {
+        if (!simulator.findLastMemWrite(static_cast<unsigned>(val))) {
+            fprintf(out, "no earlier store to 0x%08X\n", static_cast<unsigned>(val));
+            return true;
+        }
+    }
+    else if (!strcmp(command, "p") || !strcmp(command, "print")) {
+        if (simulator.getCycle()) {
+            simulator.dumpState(out);
+        }
+        else {
+            printPosition(out);
+        }
+        return true;
+    }
+    else if ((!strcmp(command, "m") || !strcmp(command, "mem")) && hasVal) {
+        unsigned word = 0u;
+        if (!simulator.peekMemory(static_cast<unsigned>(val), word)) {
+            fprintf(out, "0x%08X: out of memory\n", static_cast<unsigned>(val));
+        }
+        else {
+            fprintf(out, "0x%08X: 0x%08X\n", static_cast<unsigned>(val) & ~3u, word);
+        }
+        return true;
+    }
+    else {
+        fprintf(out, "commands: step [n], back [n], goto N, continue, last $R|ADDR, print, mem ADDR, quit\n");
+        return true;
+    }
+    printPosition(out);
+    return true;
+}
+
+void InstDebugger::printPosition(FILE* out) {
+    const unsigned cycle = simulator.getCycle();
+    if (!simulator.isAlive()) {
+        // the halting cycle did not complete, the position is the cycle before it
+        if (cycle) {
+            fprintf(out, "cycle %u, halted by a fatal error in cycle %u\n", cycle - 1u, cycle);
+        }
+        else {
+            fprintf(out, "not started, halted by a fatal error in cycle 0\n");
+        }
+    }
+    else if (!cycle) {
+        fprintf(out, "not started\n");
+    }
+    else if (!simulator.isRunning()) {
+        fprintf(out, "cycle %u, program finished\n", cycle - 1u);
+    }
+    else {
+        fprintf(out, "cycle %u\n", cycle - 1u);
+    }
+}
+
+} /* namespace lb */
@@ -0,0 +1,66 @@
+/*
+ * InstDebugger.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTDEBUGGER_H_
+#define INSTDEBUGGER_H_
+
+#include <cstdio>
+#include "InstSimulator.h"
+
+namespace lb {
+
+/**
+ * line-oriented reverse debugger over a loaded simulator,
+ * cycles are numbered as in snapshot.rpt: "cycle N" is the state printed after cycle N,
+ * commands:
+ *   s|step [n]        n cycles forward(1)
+ *   b|back [n]        n cycles back(1)
+ *   g|goto N          to cycle N
+ *   c|continue        to the end of the program
+ *   l|last $R         back to the last write back to register R
+ *   l|last ADDR       back to the last store to byte ADDR(decimal or 0x hex)
+ *   p|print           registers and pipeline, snapshot format
+ *   m|mem ADDR        data memory word holding ADDR
+ *   q|quit
+ */
+class InstDebugger {
+public:
+    /**
+     * @param simulator images loaded, startDebug() is called here
+     * @param interval cycles between checkpoints
+     * @param depth checkpoints kept
+     */
+    InstDebugger(InstSimulatorDebug& simulator, const unsigned& interval, const unsigned& depth);
+
+    InstDebugger(const InstDebugger& that) = delete;
+
+    virtual ~InstDebugger();
+
+    InstDebugger& operator=(const InstDebugger& that) = delete;
+
+    /**
+     * read commands until quit or end of input
+     * @param in commands
+     * @param out replies, prompt if in is a terminal
+     */
+    void run(FILE* in, FILE* out);
+
+private:
+    InstSimulatorDebug& simulator;
+
+private:
+    /**
+     * @return false on quit
+     */
+    bool execute(const char* line, FILE* out);
+
+    void printPosition(FILE* out);
+};
+
+} /* namespace lb */
+
+#endif /* INSTDEBUGGER_H_ */
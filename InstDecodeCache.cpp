@@ -0,0 +1,153 @@
+/*
+ * InstDecodeCache.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstDecodeCache.h"
+#include "InstAllocCounter.h"
+
+namespace lb {
+
+InstDecodeCache::InstDecodeCache() {
+    this->imageBase = 0u;
+    this->memory = nullptr;
+    this->version = 0u;
+    this->directory = nullptr;
+    this->lastPage = NO_PAGE;
+    this->lastPageData = nullptr;
+}
+
+InstDecodeCache::~InstDecodeCache() {
+    releasePages();
+}
+
+void InstDecodeCache::init() {
+    image.clear();
+    imageBase = 0u;
+    resetPages();
+}
+
+void InstDecodeCache::load(const unsigned* src, const unsigned& len, const unsigned& pc) {
+    resetPages();
+    image.assign(src, src + len);
+    imageBase = pc >> 2;
+}
+
+void InstDecodeCache::load(std::vector<unsigned>&& src, const unsigned& pc) {
+    resetPages();
+    image = std::move(src);
+    imageBase = pc >> 2;
+}
+
+void InstDecodeCache::setMemory(InstMemory* memory) {
+    this->memory = memory;
+    resetPages();
+}
+
+void InstDecodeCache::invalidate(const unsigned& addr) {
+    const unsigned index = addr >> 2;
+    const unsigned page = index >> PAGE_BITS;
+    InstDecodePage** table = directory ? directory[page >> TABLE_BITS] : nullptr;
+    if (table && table[page & (TABLE_SIZE - 1u)]) {
+        const unsigned offset = index & (PAGE_INSTS - 1u);
+        table[page & (TABLE_SIZE - 1u)]->decoded[offset >> 5] &= ~(1u << (offset & 31u));
+    }
+    ++version;
+}
+
+unsigned InstDecodeCache::getVersion() const {
+    return version;
+}
+
+unsigned InstDecodeCache::getWord(const unsigned& pc) const {
+    if (memory) {
+        return memory->getMemory(pc & ~3u, InstSize::WORD);
+    }
+    const unsigned index = (pc >> 2) - imageBase;
+    return (index < image.size()) ? image[index] : 0u;
+}
+
+unsigned InstDecodeCache::getPageCount() const {
+    return static_cast<unsigned>(pages.size());
+}
+
+void InstDecodeCache::save(InstCheckpoint& checkpoint) const {
+    checkpoint.writeWord(InstCheckpoint::TAG_DECODE);
+    checkpoint.writeWord(imageBase);
+    checkpoint.writeWord(static_cast<unsigned>(image.size()));
+    checkpoint.writeWords(image.data(), static_cast<unsigned>(image.size()));
+}
+
+void InstDecodeCache::restore(InstCheckpoint& checkpoint) {
+    checkpoint.expect(InstCheckpoint::TAG_DECODE);
+    const unsigned base = checkpoint.readWord();
+    const unsigned len = checkpoint.readWord();
+    // at most the whole 32-bit address space
+    if (base >> 30 || len > (1u << 30) - base) {
+        checkpoint.fail("corrupted checkpoint");
+        return;
+    }
+    std::vector<unsigned> words(checkpoint.good() ? len : 0u);
+    checkpoint.readWords(words.data(), static_cast<unsigned>(words.size()));
+    load(std::move(words), base << 2);
+}
+
+InstDecodeCache::InstDecodePage* InstDecodeCache::refillPage(const unsigned& index) {
+    const unsigned page = index >> PAGE_BITS;
+    // code pages are allocated on first fetch, expected at any cycle
+    InstAllocCounter::Expected expected;
+    if (!directory) {
+        directory = new InstDecodePage**[TABLE_SIZE]();
+    }
+    InstDecodePage**& table = directory[page >> TABLE_BITS];
+    if (!table) {
+        table = new InstDecodePage*[TABLE_SIZE]();
+    }
+    InstDecodePage*& data = table[page & (TABLE_SIZE - 1u)];
+    if (!data) {
+        data = new InstDecodePage();
+        memset(data->decoded, 0, sizeof(data->decoded));
+        pages.push_back(data);
+    }
+    lastPage = page;
+    lastPageData = data;
+    return data;
+}
+
+void InstDecodeCache::decode(InstDecodePage* page, const unsigned& index) {
+    const unsigned offset = index & (PAGE_INSTS - 1u);
+    if (memory) {
+        memory->markCode(index << 2);
+    }
+    page->inst[offset] = InstDecoder::decodeInstBin(getWord(index << 2));
+    page->decoded[offset >> 5] |= 1u << (offset & 31u);
+}
+
+void InstDecodeCache::resetPages() {
+    for (InstDecodePage* page : pages) {
+        memset(page->decoded, 0, sizeof(page->decoded));
+    }
+}
+
+void InstDecodeCache::releasePages() {
+    if (directory) {
+        for (unsigned i = 0; i < TABLE_SIZE; ++i) {
+            if (!directory[i]) {
+                continue;
+            }
+            for (unsigned j = 0; j < TABLE_SIZE; ++j) {
+                delete directory[i][j];
+            }
+            delete[] directory[i];
+        }
+        delete[] directory;
+        directory = nullptr;
+    }
+    pages.clear();
+    lastPage = NO_PAGE;
+    lastPageData = nullptr;
+}
+
+} /* namespace lb */
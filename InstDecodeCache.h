@@ -0,0 +1,156 @@
+/*
+ * InstDecodeCache.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTDECODECACHE_H_
+#define INSTDECODECACHE_H_
+
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "InstCheckpoint.h"
+#include "InstDataBin.h"
+#include "InstDecoder.h"
+#include "InstMemory.h"
+
+namespace lb {
+
+/**
+ * pc-indexed decoded instruction cache,
+ * an instruction is decoded on its first fetch and memoized,
+ * decoded entries live in 4 KiB code pages(1024 instructions) allocated on first fetch,
+ * found by a two-level page table with the last fetched page cached.
+ * words outside the image decode as 0(nop).
+ * with a unified memory, words are read from memory instead of the image,
+ * a store to a decoded word invalidates it
+ */
+class InstDecodeCache {
+public:
+    InstDecodeCache();
+
+    InstDecodeCache(const InstDecodeCache& that) = delete;
+
+    virtual ~InstDecodeCache();
+
+    InstDecodeCache& operator=(const InstDecodeCache& that) = delete;
+
+    /**
+     * drop image and decoded entries, code pages stay allocated for reuse
+     */
+    void init();
+
+    /**
+     * set instruction image, copies words
+     * @param src instruction words
+     * @param len number of words
+     * @param pc address of the first word
+     */
+    void load(const unsigned* src, const unsigned& len, const unsigned& pc);
+
+    /**
+     * set instruction image, takes the words without copying
+     * @param src instruction words
+     * @param pc address of the first word
+     */
+    void load(std::vector<unsigned>&& src, const unsigned& pc);
+
+    /**
+     * UNIFIED memory: read instruction words from memory, drops decoded pages
+     * @param memory unified memory, nullptr to read from the image
+     */
+    void setMemory(InstMemory* memory);
+
+    /**
+     * drop the decoded instruction holding addr, called by InstMemory on stores to code pages
+     * @param addr stored address
+     */
+    void invalidate(const unsigned& addr);
+
+    /**
+     * incremented on every invalidation, lets translated code detect stale copies
+     */
+    unsigned getVersion() const;
+
+    /**
+     * decoded instruction at pc
+     * @param pc instruction address, pc >> 2 selects the instruction
+     */
+    const InstDataBin& fetch(const unsigned& pc);
+
+    /**
+     * raw instruction word at pc, 0 outside the image
+     * @param pc instruction address
+     */
+    unsigned getWord(const unsigned& pc) const;
+
+    /**
+     * number of code pages allocated
+     */
+    unsigned getPageCount() const;
+
+    /**
+     * write the instruction image, decoded entries are rebuilt on fetch
+     * @param checkpoint checkpoint open for write
+     */
+    void save(InstCheckpoint& checkpoint) const;
+
+    /**
+     * load the instruction image written by save()
+     * @param checkpoint checkpoint open for read
+     */
+    void restore(InstCheckpoint& checkpoint);
+
+private:
+    constexpr static unsigned PAGE_BITS = 10u;
+    constexpr static unsigned PAGE_INSTS = 1024u;
+    constexpr static unsigned TABLE_BITS = 10u;
+    constexpr static unsigned TABLE_SIZE = 1024u;
+    constexpr static unsigned NO_PAGE = 0xFFFFFFFFu;
+
+private:
+    /**
+     * decoded code page, decoded: one bit per instruction
+     */
+    struct InstDecodePage {
+        InstDataBin inst[PAGE_INSTS];
+        unsigned decoded[PAGE_INSTS / 32u];
+    };
+
+private:
+    std::vector<unsigned> image;
+    unsigned imageBase;
+    InstMemory* memory;
+    unsigned version;
+    // page table, directory[page >> TABLE_BITS][page & (TABLE_SIZE - 1)], allocated with the first page
+    InstDecodePage*** directory;
+    // allocated pages, decoded bits cleared on init()
+    std::vector<InstDecodePage*> pages;
+    unsigned lastPage;
+    InstDecodePage* lastPageData;
+
+private:
+    InstDecodePage* refillPage(const unsigned& index);
+
+    void decode(InstDecodePage* page, const unsigned& index);
+
+    void resetPages();
+
+    void releasePages();
+};
+
+inline const InstDataBin& InstDecodeCache::fetch(const unsigned& pc) {
+    const unsigned index = pc >> 2;
+    InstDecodePage* page = ((index >> PAGE_BITS) == lastPage) ? lastPageData : refillPage(index);
+    const unsigned offset = index & (PAGE_INSTS - 1u);
+    if (!(page->decoded[offset >> 5] & (1u << (offset & 31u)))) {
+        decode(page, index);
+    }
+    return page->inst[offset];
+}
+
+} /* namespace lb */
+
+#endif /* INSTDECODECACHE_H_ */
@@ -9,6 +9,140 @@
 
 namespace lb {
 
+const InstDecoder::InstDecodeEntry InstDecoder::opCodeDecodeTable[64] = {
+        {InstType::R, InstClass::NONE, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x00 R-type
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x01 undef
+        {InstType::J, InstClass::BRANCH_J, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x02 j
+        {InstType::J, InstClass::BRANCH_J, InstExOp::NONE, InstDmOp::NONE, InstWbOp::ALUOUT, 0u, REG_31}, // 0x03 jal
+        {InstType::I, InstClass::BRANCH_I, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, REG_RS | REG_RT, 0u}, // 0x04 beq
+        {InstType::I, InstClass::BRANCH_I, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, REG_RS | REG_RT, 0u}, // 0x05 bne
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x06 undef
+        {InstType::I, InstClass::BRANCH_I, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, REG_RS, 0u}, // 0x07 bgtz
+        {InstType::I, InstClass::NONE, InstExOp::ADDI, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS, REG_RT}, // 0x08 addi
+        {InstType::I, InstClass::NONE, InstExOp::ADDIU, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS, REG_RT}, // 0x09 addiu
+        {InstType::I, InstClass::NONE, InstExOp::SLTI, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS, REG_RT}, // 0x0A slti
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x0B undef
+        {InstType::I, InstClass::NONE, InstExOp::ANDI, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS, REG_RT}, // 0x0C andi
+        {InstType::I, InstClass::NONE, InstExOp::ORI, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS, REG_RT}, // 0x0D ori
+        {InstType::I, InstClass::NONE, InstExOp::NORI, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS, REG_RT}, // 0x0E nori
+        {InstType::I, InstClass::NONE, InstExOp::LUI, InstDmOp::NONE, InstWbOp::ALUOUT, 0u, REG_RT}, // 0x0F lui
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x10 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x11 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x12 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x13 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x14 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x15 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x16 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x17 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x18 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x19 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x1A undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x1B undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x1C undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x1D undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x1E undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x1F undef
+        {InstType::I, InstClass::LOAD, InstExOp::MEMADDR, InstDmOp::LB, InstWbOp::MDR, REG_RS, REG_RT}, // 0x20 lb
+        {InstType::I, InstClass::LOAD, InstExOp::MEMADDR, InstDmOp::LH, InstWbOp::MDR, REG_RS, REG_RT}, // 0x21 lh
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x22 undef
+        {InstType::I, InstClass::LOAD, InstExOp::MEMADDR, InstDmOp::LW, InstWbOp::MDR, REG_RS, REG_RT}, // 0x23 lw
+        {InstType::I, InstClass::LOAD, InstExOp::MEMADDR, InstDmOp::LBU, InstWbOp::MDR, REG_RS, REG_RT}, // 0x24 lbu
+        {InstType::I, InstClass::LOAD, InstExOp::MEMADDR, InstDmOp::LHU, InstWbOp::MDR, REG_RS, REG_RT}, // 0x25 lhu
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x26 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x27 undef
+        {InstType::I, InstClass::STORE, InstExOp::MEMADDR, InstDmOp::SB, InstWbOp::NONE, REG_RS | REG_RT, 0u}, // 0x28 sb
+        {InstType::I, InstClass::STORE, InstExOp::MEMADDR, InstDmOp::SH, InstWbOp::NONE, REG_RS | REG_RT, 0u}, // 0x29 sh
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x2A undef
+        {InstType::I, InstClass::STORE, InstExOp::MEMADDR, InstDmOp::SW, InstWbOp::NONE, REG_RS | REG_RT, 0u}, // 0x2B sw
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x2C undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x2D undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x2E undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x2F undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x30 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x31 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x32 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x33 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x34 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x35 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x36 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x37 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x38 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x39 undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x3A undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x3B undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x3C undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x3D undef
+        {InstType::UNDEF, InstClass::NOP, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}, // 0x3E undef
+        {InstType::S, InstClass::HALT, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, 0u, 0u}  // 0x3F halt
+};
+
+const InstDecoder::InstDecodeEntry InstDecoder::functDecodeTable[64] = {
+        {InstType::R, InstClass::NONE, InstExOp::SLL, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RT, REG_RD}, // 0x00 sll
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x01 undef
+        {InstType::R, InstClass::NONE, InstExOp::SRL, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RT, REG_RD}, // 0x02 srl
+        {InstType::R, InstClass::NONE, InstExOp::SRA, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RT, REG_RD}, // 0x03 sra
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x04 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x05 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x06 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x07 undef
+        {InstType::R, InstClass::BRANCH_R, InstExOp::NONE, InstDmOp::NONE, InstWbOp::NONE, REG_RS, 0u}, // 0x08 jr
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x09 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x0A undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x0B undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x0C undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x0D undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x0E undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x0F undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x10 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x11 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x12 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x13 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x14 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x15 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x16 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x17 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x18 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x19 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x1A undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x1B undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x1C undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x1D undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x1E undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x1F undef
+        {InstType::R, InstClass::NONE, InstExOp::ADD, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x20 add
+        {InstType::R, InstClass::NONE, InstExOp::ADDU, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x21 addu
+        {InstType::R, InstClass::NONE, InstExOp::SUB, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x22 sub
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x23 undef
+        {InstType::R, InstClass::NONE, InstExOp::AND, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x24 and
+        {InstType::R, InstClass::NONE, InstExOp::OR, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x25 or
+        {InstType::R, InstClass::NONE, InstExOp::XOR, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x26 xor
+        {InstType::R, InstClass::NONE, InstExOp::NOR, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x27 nor
+        {InstType::R, InstClass::NONE, InstExOp::NAND, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x28 nand
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x29 undef
+        {InstType::R, InstClass::NONE, InstExOp::SLT, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x2A slt
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x2B undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x2C undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x2D undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x2E undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x2F undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x30 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x31 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x32 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x33 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x34 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x35 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x36 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x37 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x38 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x39 undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x3A undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x3B undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x3C undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x3D undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}, // 0x3E undef
+        {InstType::R, InstClass::NONE, InstExOp::ZERO, InstDmOp::NONE, InstWbOp::ALUOUT, REG_RS | REG_RT, REG_RD}  // 0x3F undef
+};
+
 InstDataStr InstDecoder::decodeInstStr(const unsigned& src) {
     unsigned opCode;
     unsigned rs, rt, rd;
@@ -20,7 +154,7 @@ InstDataStr InstDecoder::decodeInstStr(const unsigned& src) {
     std::string functStr;
     opCode = getBitsInRange(src, 26, 32);
     opCodeStr = InstLookUp::opCodeLookUp(opCode);
-    if (opCodeStr == "undef") {
+    if (opCodeDecodeTable[opCode].instType == InstType::UNDEF) {
         return InstDataStr();
     }
     else if (opCode == 0x0u) {
@@ -54,7 +188,6 @@ InstDataStr InstDecoder::decodeInstStr(const unsigned& src) {
         return ret;
     }
     else if (opCode == 0x3Fu) {
-        opCodeStr = InstLookUp::opCodeLookUp(opCode);
         InstDataStr ret;
         ret.setInstType(InstType::S);
         ret.setOpCode(opCodeStr);
@@ -78,105 +211,63 @@ InstDataStr InstDecoder::decodeInstStr(const unsigned& src) {
 }
 
 InstDataBin InstDecoder::decodeInstBin(const unsigned& src) {
-    unsigned opCode;
-    unsigned rs, rt, rd;
-    unsigned c;
-    unsigned funct;
-    std::string opCodeStr;
-    opCode = getBitsInRange(src, 26, 32);
-    opCodeStr = InstLookUp::opCodeLookUp(opCode);
-    if (opCodeStr == "undef") {
-        return InstDataBin();
+    const unsigned opCode = getBitsInRange(src, 26, 32);
+    const InstDecodeEntry* entry = &opCodeDecodeTable[opCode];
+    InstDataBin ret;
+    if (entry->instType == InstType::UNDEF) {
+        return ret;
     }
-    else if (opCode == 0x0u) {
-        funct = getBitsInRange(src, 0, 6);
-        rs = getBitsInRange(src, 21, 26);
-        rt = getBitsInRange(src, 16, 21);
-        rd = getBitsInRange(src, 11, 16);
-        c = getBitsInRange(src, 6, 11);
-        InstDataBin ret;
-        ret.setInst(src);
-        ret.setInstType(InstType::R);
-        ret.setOpCode(opCode);
-        ret.setRs(rs);
-        ret.setRt(rt);
-        ret.setRd(rd);
-        ret.setC(c);
+    ret.setInst(src);
+    ret.setInstType(entry->instType);
+    ret.setOpCode(opCode);
+    if (entry->instType == InstType::R) {
+        const unsigned funct = getBitsInRange(src, 0, 6);
+        entry = &functDecodeTable[funct];
+        ret.setRs(getBitsInRange(src, 21, 26));
+        ret.setRt(getBitsInRange(src, 16, 21));
+        ret.setRd(getBitsInRange(src, 11, 16));
+        ret.setC(getBitsInRange(src, 6, 11));
         ret.setFunct(funct);
         ret.setInstName(funct);
-        switch (funct) {
-            case 0x08u: // jr
-                ret.setRegRead(InstElement(rs, InstElementType::RS));
-                break;
-            case 0x00u: // sll
-            case 0x02u: // srl
-            case 0x03u: // sra
-                ret.setRegRead(InstElement(rt, InstElementType::RT));
-                ret.setRegWrite(InstElement(rd, InstElementType::RD));
-                break;
-            default:
-                ret.setRegRead(InstElement(rs, InstElementType::RS));
-                ret.setRegRead(InstElement(rt, InstElementType::RT));
-                ret.setRegWrite(InstElement(rd, InstElementType::RD));
-                break;
-        }
-        return ret;
     }
-    else if (opCode == 0x02u || opCode == 0x03u) {
-        c = getBitsInRange(src, 0, 26);
-        InstDataBin ret;
-        ret.setInst(src);
-        ret.setInstType(InstType::J);
-        ret.setOpCode(opCode);
-        ret.setC(c);
+    else if (entry->instType == InstType::I) {
+        ret.setRs(getBitsInRange(src, 21, 26));
+        ret.setRt(getBitsInRange(src, 16, 21));
+        ret.setC(getBitsInRange(src, 0, 16));
         ret.setInstName(opCode);
-        if (opCode == 0x03u) {
-            ret.setRegWrite(InstElement(31));
-        }
-        return ret;
     }
-    else if (opCode == 0x3Fu) {
-        InstDataBin ret;
-        ret.setInst(src);
-        ret.setInstType(InstType::S);
-        ret.setOpCode(opCode);
+    else if (entry->instType == InstType::J) {
+        ret.setC(getBitsInRange(src, 0, 26));
         ret.setInstName(opCode);
-        return ret;
     }
     else {
-        rs = getBitsInRange(src, 21, 26);
-        rt = getBitsInRange(src, 16, 21);
-        c = getBitsInRange(src, 0, 16);
-        InstDataBin ret;
-        ret.setInst(src);
-        ret.setInstType(InstType::I);
-        ret.setOpCode(opCode);
-        ret.setRs(rs);
-        ret.setRt(rt);
-        ret.setC(c);
         ret.setInstName(opCode);
-        switch (opCode) {
-            case 0x07u: // bgtz
-                ret.setRegRead(InstElement(rs, InstElementType::RS));
-                break;
-            case 0x0Fu: // lui
-                ret.setRegWrite(InstElement(rt, InstElementType::RT));
-                break;
-            case 0x04u: // beq
-            case 0x05u: // bne
-            case 0x2Bu: // sw
-            case 0x29u: // sh
-            case 0x28u: // sb
-                ret.setRegRead(InstElement(rs, InstElementType::RS));
-                ret.setRegRead(InstElement(rt, InstElementType::RT));
-                break;
-            default:
-                ret.setRegRead(InstElement(rs, InstElementType::RS));
-                ret.setRegWrite(InstElement(rt, InstElementType::RT));
-                break;
-        }
+    }
+    if (entry->regRead & REG_RS) {
+        ret.setRegRead(InstElement(ret.getRs(), InstElementType::RS));
+    }
+    if (entry->regRead & REG_RT) {
+        ret.setRegRead(InstElement(ret.getRt(), InstElementType::RT));
+    }
+    if (entry->regWrite & REG_RT) {
+        ret.setRegWrite(InstElement(ret.getRt(), InstElementType::RT));
+    }
+    else if (entry->regWrite & REG_RD) {
+        ret.setRegWrite(InstElement(ret.getRd(), InstElementType::RD));
+    }
+    else if (entry->regWrite & REG_31) {
+        ret.setRegWrite(InstElement(31));
+    }
+    if (entry->instType == InstType::R && ret.getInstNameId() == InstLookUp::NAME_NOP) {
+        // nop keeps register sets of sll, but does nothing in EX, DM, WB
+        ret.setInstClass(InstClass::NOP);
         return ret;
     }
+    ret.setInstClass(entry->instClass);
+    ret.setExOp(entry->exOp);
+    ret.setDmOp(entry->dmOp);
+    ret.setWbOp(entry->wbOp);
+    return ret;
 }
 
 } /* namespace lb */
@@ -36,6 +36,33 @@ public:
      * @param src instruction to decode
      */
     static InstDataBin decodeInstBin(const unsigned& src);
+
+private:
+    // register flags of decode table entries
+    constexpr static unsigned char REG_RS = 0x01u;
+    constexpr static unsigned char REG_RT = 0x02u;
+    constexpr static unsigned char REG_RD = 0x04u;
+    constexpr static unsigned char REG_31 = 0x08u;
+
+    /**
+     * decode table entry, everything decodeInstBin needs except fields from the word
+     * regRead, regWrite: REG_* flags
+     */
+    struct InstDecodeEntry {
+        InstType instType;
+        InstClass instClass;
+        InstExOp exOp;
+        InstDmOp dmOp;
+        InstWbOp wbOp;
+        unsigned char regRead;
+        unsigned char regWrite;
+    };
+
+    // indexed by opCode, instType UNDEF for undefined opCodes
+    const static InstDecodeEntry opCodeDecodeTable[64];
+
+    // indexed by funct of R type
+    const static InstDecodeEntry functDecodeTable[64];
 };
 
 } /* namespace lb */
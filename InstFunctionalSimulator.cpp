@@ -0,0 +1,403 @@
+/*
+ * InstFunctionalSimulator.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstFunctionalSimulator.h"
+
+namespace lb {
+
+InstFunctionalSimulator::InstFunctionalSimulator(InstMemory& memory, InstDecodeCache& decodeCache) :
+        memory(memory), decodeCache(decodeCache) {
+    errorDump = nullptr;
+    init();
+}
+
+InstFunctionalSimulator::~InstFunctionalSimulator() {
+
+}
+
+void InstFunctionalSimulator::init() {
+    pc = 0u;
+    instCount = 0u;
+    halted = false;
+    alive = true;
+    taken = false;
+    flushBlocks();
+}
+
+void InstFunctionalSimulator::flushBlocks() {
+    blockIndex.clear();
+    blocks.clear();
+    blockInst.clear();
+    decodeVersion = decodeCache.getVersion();
+}
+
+void InstFunctionalSimulator::setLogFile(FILE* errorDump) {
+    this->errorDump = errorDump;
+}
+
+void InstFunctionalSimulator::setPc(const unsigned& pc) {
+    this->pc = pc;
+    this->halted = false;
+}
+
+unsigned InstFunctionalSimulator::getPc() const {
+    return pc;
+}
+
+unsigned InstFunctionalSimulator::getInstCount() const {
+    return instCount;
+}
+
+bool InstFunctionalSimulator::isHalted() const {
+    return halted;
+}
+
+bool InstFunctionalSimulator::isBranchTaken() const {
+    return taken;
+}
+
+bool InstFunctionalSimulator::isAlive() const {
+    return alive;
+}
+
+unsigned InstFunctionalSimulator::run(const unsigned& maxInst) {
+    unsigned executed = 0u;
+    int current = -1;
+    if (decodeVersion != decodeCache.getVersion()) {
+        flushBlocks();
+    }
+    while (alive && !halted && executed < maxInst) {
+        if (current < 0) {
+            current = getBlock(pc);
+        }
+        const unsigned begin = blocks[current].begin;
+        const unsigned len = blocks[current].len;
+        unsigned instPc = blocks[current].pc;
+        unsigned edge = 0u;
+        bool chained = true;
+        bool branched = false;
+        for (unsigned i = 0; i < len; ++i) {
+            if (executed == maxInst) {
+                pc = instPc;
+                return executed;
+            }
+            const InstDataBin& inst = blockInst[begin + i];
+            ++executed;
+            ++instCount;
+            if (inst.isClass(InstClass::HALT)) {
+                pc = instPc;
+                halted = true;
+                return executed;
+            }
+            if (inst.isClass(InstClass::BRANCH)) {
+                edge = executeBranch(inst, instPc) ? 1u : 0u;
+                // jr target is not fixed, no chaining
+                chained = !inst.isClass(InstClass::BRANCH_R);
+                branched = true;
+                break;
+            }
+            if (!execute(inst)) {
+                pc = instPc;
+                alive = false;
+                return executed;
+            }
+            instPc += 4;
+            if (inst.isClass(InstClass::STORE) && decodeVersion != decodeCache.getVersion()) {
+                // stored to code, leave the block
+                break;
+            }
+        }
+        if (!branched) {
+            pc = instPc;
+        }
+        if (decodeVersion != decodeCache.getVersion()) {
+            // translated blocks may hold stale copies
+            flushBlocks();
+            current = -1;
+            continue;
+        }
+        if (!chained) {
+            current = -1;
+            continue;
+        }
+        int next = blocks[current].next[edge];
+        if (next < 0 || blocks[next].pc != pc) {
+            next = getBlock(pc);
+            blocks[current].next[edge] = next;
+        }
+        current = next;
+    }
+    return executed;
+}
+
+bool InstFunctionalSimulator::step() {
+    // a store to code only marks the entry, inst stays valid
+    return step(decodeCache.fetch(pc));
+}
+
+bool InstFunctionalSimulator::step(const InstDataBin& inst) {
+    if (!alive || halted) {
+        return false;
+    }
+    ++instCount;
+    taken = false;
+    if (inst.isClass(InstClass::HALT)) {
+        halted = true;
+        return false;
+    }
+    if (inst.isClass(InstClass::BRANCH)) {
+        taken = executeBranch(inst, pc);
+        return true;
+    }
+    if (!execute(inst)) {
+        alive = false;
+        return false;
+    }
+    pc += 4;
+    return true;
+}
+
+int InstFunctionalSimulator::getBlock(const unsigned& pc) {
+    const auto it = blockIndex.find(pc);
+    if (it != blockIndex.end()) {
+        return it->second;
+    }
+    const int ret = translate(pc);
+    blockIndex[pc] = ret;
+    return ret;
+}
+
+int InstFunctionalSimulator::translate(const unsigned& pc) {
+    InstBlock block;
+    block.pc = pc;
+    block.begin = static_cast<unsigned>(blockInst.size());
+    block.len = 0u;
+    block.next[0] = -1;
+    block.next[1] = -1;
+    unsigned instPc = pc;
+    while (block.len < InstFunctionalSimulator::MAX_BLOCK_LEN) {
+        const InstDataBin& inst = decodeCache.fetch(instPc);
+        blockInst.push_back(inst);
+        ++block.len;
+        if (inst.isClass(InstClass::BRANCH) || inst.isClass(InstClass::HALT)) {
+            break;
+        }
+        instPc += 4;
+    }
+    blocks.push_back(block);
+    return static_cast<int>(blocks.size() - 1);
+}
+
+bool InstFunctionalSimulator::execute(const InstDataBin& inst) {
+    const unsigned valRs = memory.getRegister(inst.getRs());
+    const unsigned valRt = memory.getRegister(inst.getRt());
+    const unsigned valC = inst.getC();
+    unsigned ALUOut = 0u;
+    unsigned MDR = 0u;
+    switch (static_cast<InstExOp>(inst.getExOp())) {
+        case InstExOp::NONE:
+        case InstExOp::ZERO:
+            break;
+        case InstExOp::ADD:
+            detectNumberOverflow(toSigned(valRs), toSigned(valRt), InstOpType::ADD);
+            ALUOut = valRs + valRt;
+            break;
+        case InstExOp::ADDU:
+            ALUOut = valRs + valRt;
+            break;
+        case InstExOp::SUB:
+            detectNumberOverflow(toSigned(valRs), toSigned(valRt), InstOpType::SUB);
+            ALUOut = valRs - valRt;
+            break;
+        case InstExOp::AND:
+            ALUOut = valRs & valRt;
+            break;
+        case InstExOp::OR:
+            ALUOut = valRs | valRt;
+            break;
+        case InstExOp::XOR:
+            ALUOut = valRs ^ valRt;
+            break;
+        case InstExOp::NOR:
+            ALUOut = ~(valRs | valRt);
+            break;
+        case InstExOp::NAND:
+            ALUOut = ~(valRs & valRt);
+            break;
+        case InstExOp::SLT:
+            ALUOut = static_cast<unsigned>(toSigned(valRs) < toSigned(valRt));
+            break;
+        case InstExOp::SLL:
+            ALUOut = valRt << valC;
+            break;
+        case InstExOp::SRL:
+            ALUOut = valRt >> valC;
+            break;
+        case InstExOp::SRA:
+            ALUOut = static_cast<unsigned>(toSigned(valRt) >> static_cast<int>(valC));
+            break;
+        case InstExOp::ADDI:
+        case InstExOp::MEMADDR:
+            detectNumberOverflow(toSigned(valRs), toSigned(valC, 16), InstOpType::ADD);
+            ALUOut = valRs + toUnsigned(toSigned(valC, 16));
+            break;
+        case InstExOp::ADDIU:
+            ALUOut = valRs + toUnsigned(toSigned(valC, 16));
+            break;
+        case InstExOp::LUI:
+            ALUOut = valC << 16;
+            break;
+        case InstExOp::ANDI:
+            ALUOut = valRs & valC;
+            break;
+        case InstExOp::ORI:
+            ALUOut = valRs | valC;
+            break;
+        case InstExOp::NORI:
+            ALUOut = ~(valRs | valC);
+            break;
+        case InstExOp::SLTI:
+            ALUOut = static_cast<unsigned>(toSigned(valRs) < toSigned(valC, 16));
+            break;
+    }
+    switch (static_cast<InstDmOp>(inst.getDmOp())) {
+        case InstDmOp::NONE:
+            break;
+        case InstDmOp::LW:
+            if (detectMemAccess(ALUOut, InstSize::WORD) == InstAction::HALT) {
+                return false;
+            }
+            MDR = memory.getMemory(ALUOut, InstSize::WORD);
+            break;
+        case InstDmOp::LH:
+            if (detectMemAccess(ALUOut, InstSize::HALF) == InstAction::HALT) {
+                return false;
+            }
+            MDR = toUnsigned(toSigned(memory.getMemory(ALUOut, InstSize::HALF), InstSize::HALF));
+            break;
+        case InstDmOp::LHU:
+            if (detectMemAccess(ALUOut, InstSize::HALF) == InstAction::HALT) {
+                return false;
+            }
+            MDR = memory.getMemory(ALUOut, InstSize::HALF);
+            break;
+        case InstDmOp::LB:
+            if (detectMemAccess(ALUOut, InstSize::BYTE) == InstAction::HALT) {
+                return false;
+            }
+            MDR = toUnsigned(toSigned(memory.getMemory(ALUOut, InstSize::BYTE), InstSize::BYTE));
+            break;
+        case InstDmOp::LBU:
+            if (detectMemAccess(ALUOut, InstSize::BYTE) == InstAction::HALT) {
+                return false;
+            }
+            MDR = memory.getMemory(ALUOut, InstSize::BYTE);
+            break;
+        case InstDmOp::SW:
+            if (detectMemAccess(ALUOut, InstSize::WORD) == InstAction::HALT) {
+                return false;
+            }
+            memory.setMemory(ALUOut, valRt, InstSize::WORD);
+            break;
+        case InstDmOp::SH:
+            if (detectMemAccess(ALUOut, InstSize::HALF) == InstAction::HALT) {
+                return false;
+            }
+            memory.setMemory(ALUOut, valRt, InstSize::HALF);
+            break;
+        case InstDmOp::SB:
+            if (detectMemAccess(ALUOut, InstSize::BYTE) == InstAction::HALT) {
+                return false;
+            }
+            memory.setMemory(ALUOut, valRt, InstSize::BYTE);
+            break;
+    }
+    switch (static_cast<InstWbOp>(inst.getWbOp())) {
+        case InstWbOp::NONE:
+            break;
+        case InstWbOp::ALUOUT:
+            detectWriteRegZero(inst.getRegWrite().at(0).val);
+            memory.setRegister(inst.getRegWrite().at(0).val, ALUOut);
+            break;
+        case InstWbOp::MDR:
+            detectWriteRegZero(inst.getRegWrite().at(0).val);
+            memory.setRegister(inst.getRegWrite().at(0).val, MDR);
+            break;
+    }
+    return true;
+}
+
+bool InstFunctionalSimulator::executeBranch(const InstDataBin& inst, const unsigned& instPc) {
+    if (inst.isClass(InstClass::BRANCH_R)) {
+        pc = memory.getRegister(inst.getRs());
+        return true;
+    }
+    else if (inst.isClass(InstClass::BRANCH_I)) {
+        const unsigned valRs = memory.getRegister(inst.getRs());
+        const unsigned valRt = memory.getRegister(inst.getRt());
+        bool result;
+        switch (inst.getOpCode()) {
+            case 0x04u:
+                result = (valRs == valRt);
+                break;
+            case 0x05u:
+                result = (valRs != valRt);
+                break;
+            case 0x07u:
+                result = (toSigned(valRs) > 0);
+                break;
+            default:
+                result = false;
+                break;
+        }
+        if (result) {
+            pc = instPc + 4 + toUnsigned(4 * toSigned(inst.getC(), 16));
+        }
+        else {
+            pc = instPc + 4;
+        }
+        return result;
+    }
+    else {
+        if (inst.getOpCode() == 0x03u) {
+            memory.setRegister(31, instPc + 4);
+        }
+        pc = ((instPc + 4) & 0xF0000000u) | (inst.getC() * 4);
+        return true;
+    }
+}
+
+void InstFunctionalSimulator::detectWriteRegZero(const unsigned& addr) {
+    if (errorDump && !InstErrorDetector::isRegWritable(addr)) {
+        fprintf(errorDump, "In cycle %u: Write $0 Error\n", instCount);
+    }
+}
+
+void InstFunctionalSimulator::detectNumberOverflow(const int& a, const int& b, const InstOpType& op) {
+    if (errorDump && InstErrorDetector::isOverflowed(a, b, op)) {
+        fprintf(errorDump, "In cycle %u: Number Overflow\n", instCount);
+    }
+}
+
+InstAction InstFunctionalSimulator::detectMemAccess(const unsigned& addr, const InstSize& type) {
+    InstAction action = InstAction::CONTINUE;
+    if (memory.getModel() == InstMemoryModel::FLAT && !InstErrorDetector::isValidMemoryAddr(addr, type)) {
+        if (errorDump) {
+            fprintf(errorDump, "In cycle %u: Address Overflow\n", instCount);
+        }
+        action = InstAction::HALT;
+    }
+    if (!InstErrorDetector::isAlignedAddr(addr, type)) {
+        if (errorDump) {
+            fprintf(errorDump, "In cycle %u: Misalignment Error\n", instCount);
+        }
+        action = InstAction::HALT;
+    }
+    return action;
+}
+
+} /* namespace lb */
@@ -0,0 +1,140 @@
+/*
+ * InstFunctionalSimulator.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTFUNCTIONALSIMULATOR_H_
+#define INSTFUNCTIONALSIMULATOR_H_
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+#include "InstDataBin.h"
+#include "InstDecodeCache.h"
+#include "InstErrorDetector.h"
+#include "InstMemory.h"
+#include "InstType.h"
+#include "InstUtility.h"
+
+namespace lb {
+
+/**
+ * functional(ISA level) simulator, no pipeline timing
+ * executes basic blocks translated from decoded instructions,
+ * translation cache is keyed by pc and blocks are chained on first exit.
+ * shares memory and decoded instructions with the owner(InstSimulator)
+ * a store to code(unified memory) flushes all translated blocks
+ */
+class InstFunctionalSimulator {
+private:
+    constexpr static unsigned MAX_BLOCK_LEN = 64u;
+
+public:
+    /**
+     * @param memory registers and data memory to execute on
+     * @param decodeCache decoded instructions
+     */
+    InstFunctionalSimulator(InstMemory& memory, InstDecodeCache& decodeCache);
+
+    virtual ~InstFunctionalSimulator();
+
+    /**
+     * drop translation cache, reset pc and state
+     */
+    void init();
+
+    void setLogFile(FILE* errorDump);
+
+    void setPc(const unsigned& pc);
+
+    unsigned getPc() const;
+
+    /**
+     * number of instructions executed since init(),
+     * used as cycle number in error dump
+     */
+    unsigned getInstCount() const;
+
+    /**
+     * run until halt, error halt, or maxInst instructions executed
+     * @param maxInst maximum number of instructions to execute
+     * @return number of instructions executed
+     */
+    unsigned run(const unsigned& maxInst);
+
+    /**
+     * execute one instruction at pc without translation,
+     * for callers stepping with their own checks in between
+     * @return false if halted, halted now or stopped by an error
+     */
+    bool step();
+
+    /**
+     * step() with inst in place of the instruction at pc
+     */
+    bool step(const InstDataBin& inst);
+
+    /**
+     * the instruction of the last step() was a branch or jump and it was taken
+     */
+    bool isBranchTaken() const;
+
+    /**
+     * halt instruction reached
+     */
+    bool isHalted() const;
+
+    /**
+     * stopped by address overflow or misalignment
+     */
+    bool isAlive() const;
+
+private:
+    /**
+     * translated basic block
+     * next[0]: fall through successor, next[1]: taken successor, -1 if not chained
+     */
+    struct InstBlock {
+        unsigned pc;
+        unsigned begin;
+        unsigned len;
+        int next[2];
+    };
+
+private:
+    InstMemory& memory;
+    InstDecodeCache& decodeCache;
+    unsigned pc;
+    unsigned instCount;
+    bool halted;
+    bool alive;
+    bool taken;
+    FILE* errorDump;
+    unsigned decodeVersion;
+    std::unordered_map<unsigned, int> blockIndex;
+    std::vector<InstBlock> blocks;
+    std::vector<InstDataBin> blockInst;
+
+private:
+    void flushBlocks();
+
+    int getBlock(const unsigned& pc);
+
+    int translate(const unsigned& pc);
+
+    bool execute(const InstDataBin& inst);
+
+    bool executeBranch(const InstDataBin& inst, const unsigned& instPc);
+
+    void detectWriteRegZero(const unsigned& addr);
+
+    void detectNumberOverflow(const int& a, const int& b, const InstOpType& op);
+
+    InstAction detectMemAccess(const unsigned& addr, const InstSize& type);
+};
+
+} /* namespace lb */
+
+#endif /* INSTFUNCTIONALSIMULATOR_H_ */
@@ -0,0 +1,79 @@
+/*
+ * InstHistory.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include <algorithm>
+#include "InstHistory.h"
+
+namespace lb {
+
+InstHistory::InstHistory() {
+    this->depth = 2u;
+}
+
+InstHistory::~InstHistory() {
+
+}
+
+void InstHistory::init(const unsigned& depth) {
+    this->depth = std::max(depth, 2u);
+    entries.clear();
+    // no reallocation, the newest journal is written through a pointer
+    entries.reserve(this->depth);
+}
+
+void InstHistory::clear() {
+    std::vector<InstHistoryEntry>().swap(entries);
+}
+
+unsigned InstHistory::size() const {
+    return static_cast<unsigned>(entries.size());
+}
+
+InstHistoryEntry& InstHistory::at(const unsigned& index) {
+    return entries[index];
+}
+
+InstHistoryEntry& InstHistory::push() {
+    if (entries.size() == depth) {
+        fold();
+    }
+    entries.emplace_back();
+    return entries.back();
+}
+
+void InstHistory::truncate(const unsigned& index) {
+    if (index + 1u < entries.size()) {
+        entries.erase(entries.begin() + (index + 1u), entries.end());
+    }
+}
+
+unsigned InstHistory::find(const unsigned& cycle) const {
+    unsigned index = size();
+    while (index > 1u && entries[index - 1u].cycle > cycle) {
+        --index;
+    }
+    return index ? index - 1u : 0u;
+}
+
+void InstHistory::fold() {
+    InstMemoryJournal& oldest = entries[0].journal;
+    std::vector<unsigned> numbers;
+    for (const InstMemoryJournalPage& page : oldest) {
+        numbers.push_back(page.number);
+    }
+    std::sort(numbers.begin(), numbers.end());
+    for (const InstMemoryJournalPage& page : entries[1].journal) {
+        if (!std::binary_search(numbers.begin(), numbers.end(), page.number)) {
+            oldest.push_back(page);
+        }
+    }
+    entries[0].regWrites |= entries[1].regWrites;
+    entries[0].memWrites |= entries[1].memWrites;
+    entries.erase(entries.begin() + 1);
+}
+
+} /* namespace lb */
@@ -0,0 +1,102 @@
+/*
+ * InstHistory.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTHISTORY_H_
+#define INSTHISTORY_H_
+
+#include <vector>
+#include "InstMemory.h"
+#include "InstPipeline.h"
+#include "InstType.h"
+
+namespace lb {
+
+/**
+ * lightweight checkpoint for reverse execution,
+ * state at cycle plus the undo journal of the memory pages stored to
+ * from cycle until the next checkpoint
+ */
+struct InstHistoryEntry {
+    unsigned cycle;
+    unsigned pc;
+    bool alive;
+    // statistics: cycle, retire, stall, flush
+    unsigned stats[4];
+    unsigned reg[32];
+    InstPipeline pipeline;
+    InstElementList<2> idForward;
+    InstElementList<2> exForward;
+    // held cycles left for the access in DM
+    unsigned memoryWait;
+    // registers written back from cycle until the next checkpoint, one bit per register
+    unsigned regWrites;
+    // words stored to in the same interval, bit (address >> 2) & 31, may alias
+    unsigned memWrites;
+    InstMemoryJournal journal;
+};
+
+/**
+ * bounded checkpoint history, oldest first,
+ * the oldest entry is kept so any cycle stays reachable,
+ * when full the second oldest is folded into it
+ */
+class InstHistory {
+public:
+    InstHistory();
+
+    virtual ~InstHistory();
+
+    /**
+     * drop all entries
+     * @param depth entries kept, at least 2
+     */
+    void init(const unsigned& depth);
+
+    /**
+     * drop all entries and release their memory
+     */
+    void clear();
+
+    unsigned size() const;
+
+    /**
+     * @param index 0(oldest) to size() - 1(newest)
+     */
+    InstHistoryEntry& at(const unsigned& index);
+
+    /**
+     * append an entry with an empty journal, folds the second oldest when full,
+     * the reference stays valid until the next push() or truncate()
+     */
+    InstHistoryEntry& push();
+
+    /**
+     * drop entries after index
+     */
+    void truncate(const unsigned& index);
+
+    /**
+     * index of the newest entry at or before cycle, 0 if none
+     */
+    unsigned find(const unsigned& cycle) const;
+
+private:
+    std::vector<InstHistoryEntry> entries;
+    unsigned depth;
+
+private:
+    /**
+     * merge the second oldest entry into the oldest:
+     * a page first stored to after the oldest entry keeps its older copy,
+     * the others are taken from the second oldest, written registers and words are merged
+     */
+    void fold();
+};
+
+} /* namespace lb */
+
+#endif /* INSTHISTORY_H_ */
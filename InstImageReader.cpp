@@ -55,6 +55,43 @@ unsigned InstImageReader::readImageD(FILE* dimage, unsigned* dst, unsigned* sp)
     return wordRead;
 }
 
+unsigned InstImageReader::readImageI(const std::string& filePath, std::vector<unsigned>& dst, unsigned* pc) {
+    dst.clear();
+    FILE* iimage = fopen(filePath.c_str(), "rb");
+    if (!iimage) {
+        *pc = 0u;
+        fprintf(stderr, "%s: %s\n", filePath.c_str(), strerror(errno));
+        return 0u;
+    }
+    unsigned ret = readImage(iimage, dst, pc);
+    fclose(iimage);
+    return ret;
+}
+
+unsigned InstImageReader::readImageD(const std::string& filePath, std::vector<unsigned>& dst, unsigned* sp) {
+    dst.clear();
+    FILE* dimage = fopen(filePath.c_str(), "rb");
+    if (!dimage) {
+        *sp = 0u;
+        fprintf(stderr, "%s: %s\n", filePath.c_str(), strerror(errno));
+        return 0u;
+    }
+    unsigned ret = readImage(dimage, dst, sp);
+    fclose(dimage);
+    return ret;
+}
+
+unsigned InstImageReader::readImage(FILE* image, std::vector<unsigned>& dst, unsigned* start) {
+    *start = readWordFromBin(image);
+    unsigned len = readWordFromBin(image);
+    dst.clear();
+    unsigned char input[4];
+    while (dst.size() < len && fread(input, sizeof(unsigned char), 4, image) == 4u) {
+        dst.push_back((input[0] << 24) | (input[1] << 16) | (input[2] << 8) | (input[3]));
+    }
+    return static_cast<unsigned>(dst.size());
+}
+
 unsigned InstImageReader::readWordFromBin(FILE* fin) {
     unsigned char input[4];
     if (fread(input, sizeof(unsigned char), 4, fin) != 4u) {
@@ -13,6 +13,7 @@
 #include <cstring>
 #include <cerrno>
 #include <string>
+#include <vector>
 
 namespace lb {
 
@@ -29,6 +30,16 @@ public:
 
     static unsigned readImageD(FILE* dimage, unsigned* dst, unsigned* sp);
 
+    /**
+     * read whole image, no size limit,
+     * stops at end of file if the image is shorter than its header says
+     */
+    static unsigned readImageI(const std::string& filePath, std::vector<unsigned>& dst, unsigned* pc);
+
+    static unsigned readImageD(const std::string& filePath, std::vector<unsigned>& dst, unsigned* sp);
+
+    static unsigned readImage(FILE* image, std::vector<unsigned>& dst, unsigned* start);
+
 public:
     static unsigned readWordFromBin(FILE* fin);
 };
@@ -0,0 +1,136 @@
+/*
+ * InstIntervalModel.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstIntervalModel.h"
+#include "InstPipeline.h"
+
+namespace lb {
+
+InstIntervalModel::InstIntervalModel() {
+    memoryLatency = 1u;
+    init();
+}
+
+InstIntervalModel::~InstIntervalModel() {
+
+}
+
+void InstIntervalModel::init() {
+    exWrite = 0u;
+    exLoad = 0u;
+    dmWrite = 0u;
+    dmLoad = 0u;
+    inst = 0u;
+    memoryAccess = 0u;
+    loadStall = 0u;
+    branchStall = 0u;
+    otherStall = 0u;
+    flush = 0u;
+    retire = 0u;
+    cycle = 0u;
+    faulted = false;
+    endReason = InstTraceEnd::NONE;
+}
+
+void InstIntervalModel::setMemoryLatency(const unsigned& latency) {
+    memoryLatency = latency ? latency : 1u;
+}
+
+void InstIntervalModel::write(const unsigned&, const InstDataBin& inst, const unsigned&,
+                              const bool& taken, const bool& fault) {
+    if (faulted || endReason != InstTraceEnd::NONE) {
+        return;
+    }
+    ++this->inst;
+    if (inst.isClass(InstClass::LOAD) || inst.isClass(InstClass::STORE)) {
+        ++memoryAccess;
+    }
+    if (!inst.isClass(InstClass::NOP) && !fault) {
+        ++retire;
+    }
+    const bool branch = inst.isClass(InstClass::BRANCH);
+    if (!inst.isClass(InstClass::NOP) && !inst.isClass(InstClass::HALT)) {
+        const unsigned read = inst.getRegReadMask();
+        for (;;) {
+            // a register written by both EX and DM depends on EX only
+            const unsigned dEX = read & exWrite;
+            const unsigned dDM = read & dmWrite & ~exWrite;
+            if ((dEX & exLoad) || (dDM & dmLoad)) {
+                ++loadStall;
+            }
+            else if (branch && dEX) {
+                ++branchStall;
+            }
+            else if (!branch && dDM) {
+                // a non-branch is forwarded from EX only
+                ++otherStall;
+            }
+            else {
+                break;
+            }
+            // a bubble enters EX, ID waits
+            issue(0u, 0u);
+        }
+    }
+    if (fault) {
+        // stops the pipeline in DM, everything older is written back
+        faulted = true;
+        return;
+    }
+    const unsigned write = inst.getRegWriteMask();
+    issue(write, inst.isClass(InstClass::LOAD) ? write : 0u);
+    if (branch && taken) {
+        // the flushed fetch follows as a bubble
+        ++flush;
+        issue(0u, 0u);
+    }
+}
+
+void InstIntervalModel::end(const InstTraceEnd& reason) {
+    if (endReason != InstTraceEnd::NONE) {
+        return;
+    }
+    endReason = reason;
+    const unsigned stall = loadStall + branchStall + otherStall;
+    const unsigned held = (memoryLatency - 1u) * memoryAccess;
+    cycle = inst + stall + flush + held;
+    if (faulted) {
+        // reaches DM three cycles after its fetch, faults in the next one, not counted
+        cycle += 3u;
+    }
+    else if (reason == InstTraceEnd::HALT) {
+        // ends with a halt in every stage, the one in WB not written back yet
+        retire -= InstPipeline::STAGES;
+    }
+}
+
+unsigned InstIntervalModel::getCycle() const {
+    return cycle;
+}
+
+unsigned InstIntervalModel::getRetire() const {
+    return retire;
+}
+
+double InstIntervalModel::getCPI() const {
+    return retire ? static_cast<double>(cycle) / retire : 0.0;
+}
+
+void InstIntervalModel::report(FILE* fp) const {
+    fprintf(fp, "estimate: cycles %u, instructions %u, CPI %.3f\n", cycle, retire, getCPI());
+    fprintf(fp, "  stalls: load-use %u, branch %u, other %u\n", loadStall, branchStall, otherStall);
+    fprintf(fp, "  flushes %u, held cycles %u\n", flush, (memoryLatency - 1u) * memoryAccess);
+}
+
+void InstIntervalModel::issue(const unsigned& write, const unsigned& load) {
+    dmWrite = exWrite;
+    dmLoad = exLoad;
+    exWrite = write;
+    exLoad = load;
+}
+
+} /* namespace lb */
@@ -0,0 +1,99 @@
+/*
+ * InstIntervalModel.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTINTERVALMODEL_H_
+#define INSTINTERVALMODEL_H_
+
+#include <cstdio>
+#include "InstDataBin.h"
+#include "InstTrace.h"
+
+namespace lb {
+
+/**
+ * first-order interval model of the pipeline, fed by a functional run,
+ * every instruction costs one cycle, penalty intervals are added on top:
+ * stall cycles by the InstSimulator::hasToStall() rules, one flushed fetch per taken branch,
+ * latency - 1 held cycles per load or store, and the drain at the end.
+ * stalls are found on the last two instructions issued, with the bubbles of earlier
+ * stalls and flushes, so the model needs no latches and no cycle loop
+ */
+class InstIntervalModel {
+public:
+    InstIntervalModel();
+
+    InstIntervalModel(const InstIntervalModel& that) = delete;
+
+    virtual ~InstIntervalModel();
+
+    InstIntervalModel& operator=(const InstIntervalModel& that) = delete;
+
+    /**
+     * clear counters, keeps the latency
+     */
+    void init();
+
+    /**
+     * @param latency cycles per load or store in DM, at least 1(default)
+     */
+    void setMemoryLatency(const unsigned& latency);
+
+    /**
+     * one instruction executed, same as InstTrace::write() so a recording run can feed either,
+     * instructions after a fault are ignored
+     */
+    void write(const unsigned& pc, const InstDataBin& inst, const unsigned& addr,
+               const bool& taken, const bool& fault);
+
+    /**
+     * the run ended, estimates are complete
+     */
+    void end(const InstTraceEnd& reason);
+
+    unsigned getCycle() const;
+
+    /**
+     * instructions written back, halts included, like InstStatsCounter
+     */
+    unsigned getRetire() const;
+
+    double getCPI() const;
+
+    /**
+     * print the estimate and its penalty intervals
+     */
+    void report(FILE* fp) const;
+
+private:
+    unsigned memoryLatency;
+    // registers written by the instructions in EX and DM when the next one is in ID
+    unsigned exWrite;
+    unsigned exLoad;
+    unsigned dmWrite;
+    unsigned dmLoad;
+    unsigned inst;
+    unsigned memoryAccess;
+    unsigned loadStall;
+    unsigned branchStall;
+    unsigned otherStall;
+    unsigned flush;
+    // instructions but nop, and the fault
+    unsigned retire;
+    unsigned cycle;
+    bool faulted;
+    InstTraceEnd endReason;
+
+private:
+    /**
+     * next stage for EX and DM, an instruction or a bubble
+     */
+    void issue(const unsigned& write, const unsigned& load);
+};
+
+} /* namespace lb */
+
+#endif /* INSTINTERVALMODEL_H_ */
@@ -102,6 +102,139 @@ const std::string InstLookUp::functLookUpTable[] = {
         "slt"     // 0x30
 };
 
+const char* const InstLookUp::instNameLookUpTable[] = {
+        "",       // NAME_UNDEF
+        "NOP",    // NAME_NOP
+        "R-TYPE", // NAME_OPCODE + 0x00
+        "UNDEF",
+        "J",
+        "JAL",
+        "BEQ",
+        "BNE",    // NAME_OPCODE + 0x05
+        "UNDEF",
+        "BGTZ",
+        "ADDI",
+        "ADDIU",
+        "SLTI",   // NAME_OPCODE + 0x0A
+        "UNDEF",
+        "ANDI",
+        "ORI",
+        "NORI",
+        "LUI",    // NAME_OPCODE + 0x0F
+        "UNDEF",  // NAME_OPCODE + 0x10
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_OPCODE + 0x15
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_OPCODE + 0x1A
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_OPCODE + 0x1F
+        "LB",     // NAME_OPCODE + 0x20
+        "LH",
+        "UNDEF",
+        "LW",
+        "LBU",
+        "LHU",    // NAME_OPCODE + 0x25
+        "UNDEF",
+        "UNDEF",
+        "SB",
+        "SH",
+        "UNDEF",  // NAME_OPCODE + 0x2A
+        "SW",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_OPCODE + 0x2F
+        "UNDEF",  // NAME_OPCODE + 0x30
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_OPCODE + 0x35
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_OPCODE + 0x3A
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "HALT",   // NAME_OPCODE + 0x3F
+        "SLL",    // NAME_FUNCT + 0x00
+        "UNDEF",
+        "SRL",
+        "SRA",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x05
+        "UNDEF",
+        "UNDEF",
+        "JR",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x0A
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x0F
+        "UNDEF",  // NAME_FUNCT + 0x10
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x15
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x1A
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x1F
+        "ADD",    // NAME_FUNCT + 0x20
+        "ADDU",
+        "SUB",
+        "UNDEF",
+        "AND",
+        "OR",     // NAME_FUNCT + 0x25
+        "XOR",
+        "NOR",
+        "NAND",
+        "UNDEF",
+        "SLT",    // NAME_FUNCT + 0x2A
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x2F
+        "UNDEF",  // NAME_FUNCT + 0x30
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x35
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",  // NAME_FUNCT + 0x3A
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF",
+        "UNDEF"   // NAME_FUNCT + 0x3F
+};
+
 std::string InstLookUp::opCodeLookUp(const unsigned& src) {
     if (src == 0x3Fu) {
         return "halt";
@@ -119,6 +252,21 @@ std::string InstLookUp::functLookUp(const unsigned& src) {
     return InstLookUp::functLookUpTable[src];
 }
 
+unsigned InstLookUp::opCodeNameId(const unsigned& src) {
+    return InstLookUp::NAME_OPCODE + (src & 0x3Fu);
+}
+
+unsigned InstLookUp::functNameId(const unsigned& src) {
+    return InstLookUp::NAME_FUNCT + (src & 0x3Fu);
+}
+
+const char* InstLookUp::instNameLookUp(const unsigned& id) {
+    if (id >= InstLookUp::NAME_END) {
+        return "";
+    }
+    return InstLookUp::instNameLookUpTable[id];
+}
+
 std::string InstLookUp::registerLookUpNumber(const unsigned& src) {
     if (src > 0x1Fu) {
         return "undef";
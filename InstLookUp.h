@@ -14,6 +14,17 @@
 namespace lb {
 
 class InstLookUp {
+public:
+    /**
+     * instruction name ids, index of instNameLookUp
+     * NAME_OPCODE + opCode for I, J, S type, NAME_FUNCT + funct for R type
+     */
+    constexpr static unsigned NAME_UNDEF = 0u;
+    constexpr static unsigned NAME_NOP = 1u;
+    constexpr static unsigned NAME_OPCODE = 2u;
+    constexpr static unsigned NAME_FUNCT = 66u;
+    constexpr static unsigned NAME_END = 130u;
+
 public:
     /**
      * translate opCode -> readable string
@@ -33,7 +44,26 @@ public:
      */
     static std::string registerLookUpNumber(const unsigned& src);
 
+    /**
+     * translate opCode -> instruction name id
+     * @param src opCode to translate
+     */
+    static unsigned opCodeNameId(const unsigned& src);
+
+    /**
+     * translate funct -> instruction name id
+     * @param src funct to translate
+     */
+    static unsigned functNameId(const unsigned& src);
+
+    /**
+     * translate instruction name id -> upper case name, no allocation
+     * @param id instruction name id to translate
+     */
+    static const char* instNameLookUp(const unsigned& id);
+
 private:
+    const static char* const instNameLookUpTable[];
     const static std::string opCodeLookUpTable[];
     const static std::string functLookUpTable[];
 };
@@ -0,0 +1,383 @@
+/*
+ * InstLoopAccel.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include "InstLoopAccel.h"
+#include "InstUtility.h"
+
+namespace lb {
+
+constexpr unsigned InstLoopAccel::MAX_BODY;
+constexpr unsigned InstLoopAccel::STATE_CYCLE;
+constexpr unsigned InstLoopAccel::STATE_STATS;
+constexpr unsigned InstLoopAccel::STATE_REG;
+constexpr unsigned InstLoopAccel::STATE_LATCH;
+constexpr unsigned InstLoopAccel::STATE_WORDS;
+constexpr unsigned InstLoopAccel::SIGNATURE_WORDS;
+constexpr unsigned InstLoopAccel::EDGES;
+constexpr unsigned InstLoopAccel::MAX_OPS;
+constexpr unsigned InstLoopAccel::MAX_STORES;
+constexpr unsigned InstLoopAccel::MAX_BACKOFF;
+constexpr unsigned InstLoopAccel::NONE;
+
+InstLoopAccel::InstLoopAccel() {
+    init();
+}
+
+InstLoopAccel::~InstLoopAccel() {
+
+}
+
+void InstLoopAccel::init() {
+    branchPc = NONE;
+    target = NONE;
+    proved = false;
+    head = 0u;
+    count = 0u;
+    idle = 0u;
+    backoff = 1u;
+}
+
+bool InstLoopAccel::isSelected(const unsigned& branchPc, const unsigned& target) const {
+    return this->branchPc == branchPc && this->target == target;
+}
+
+void InstLoopAccel::select(const unsigned& branchPc, const unsigned& target, const InstDataBin* body, const unsigned& len) {
+    this->branchPc = branchPc;
+    this->target = target;
+    proved = prove(body, len);
+    head = 0u;
+    count = 0u;
+    idle = 0u;
+    backoff = 1u;
+}
+
+bool InstLoopAccel::isTracing() const {
+    return proved && count;
+}
+
+bool InstLoopAccel::pollEdge() {
+    if (!proved) {
+        return false;
+    }
+    if (idle) {
+        --idle;
+        return false;
+    }
+    return true;
+}
+
+void InstLoopAccel::backOff() {
+    idle = backoff;
+    backoff = std::min(backoff * 2u, MAX_BACKOFF);
+    count = 0u;
+}
+
+void InstLoopAccel::recordOperands(const int& a, const int& b, const InstOpType& op) {
+    InstLoopTrace& current = trace[head];
+    if (current.opCount == MAX_OPS) {
+        current.full = true;
+        return;
+    }
+    current.operand[current.opCount][0] = toUnsigned(a);
+    current.operand[current.opCount][1] = toUnsigned(b);
+    current.op[current.opCount] = op;
+    ++current.opCount;
+}
+
+void InstLoopAccel::recordStore(const unsigned& addr, const unsigned& val, const InstSize& type) {
+    InstLoopTrace& current = trace[head];
+    if (current.storeCount == MAX_STORES) {
+        current.full = true;
+        return;
+    }
+    current.store[current.storeCount][0] = addr;
+    current.store[current.storeCount][1] = val;
+    current.store[current.storeCount][2] = static_cast<unsigned>(type);
+    ++current.storeCount;
+}
+
+bool InstLoopAccel::addEdge(const unsigned* state, const unsigned* signature) {
+    memcpy(this->state[head], state, sizeof(unsigned) * STATE_WORDS);
+    memcpy(this->signature[head], signature, sizeof(unsigned) * SIGNATURE_WORDS);
+    head = (head + 1u) % EDGES;
+    count = std::min(count + 1u, EDGES);
+    trace[head].opCount = 0u;
+    trace[head].storeCount = 0u;
+    trace[head].full = false;
+    if (count < EDGES) {
+        return false;
+    }
+    if (!isConsistent()) {
+        backOff();
+        return false;
+    }
+    return true;
+}
+
+unsigned InstLoopAccel::getSkipCount(const unsigned& branchOp, const bool& flat, const unsigned& cycleRoom) const {
+    const unsigned* newest = state[slot(0u)];
+    const unsigned* older = state[slot(1u)];
+    unsigned skipCount = cycleRoom / (newest[STATE_CYCLE] - older[STATE_CYCLE]);
+    skipCount = std::min(skipCount, getExitCount(branchOp));
+    const InstLoopTrace& last = trace[slot(0u)];
+    const InstLoopTrace& prev = trace[slot(1u)];
+    for (unsigned i = 0; i < last.opCount; ++i) {
+        // the detector negates the second operand of a subtraction, INT_MIN would not negate
+        const bool sub = (last.op[i] == InstOpType::SUB);
+        const long long a = toSigned(last.operand[i][0]);
+        const long long b = toSigned(last.operand[i][1]);
+        const long long stepA = toSigned(last.operand[i][0] - prev.operand[i][0]);
+        const long long stepB = toSigned(last.operand[i][1] - prev.operand[i][1]);
+        skipCount = bound(skipCount, a, stepA, INT_MIN, INT_MAX);
+        skipCount = bound(skipCount, b, stepB, sub ? INT_MIN + 1ll : INT_MIN, INT_MAX);
+        skipCount = bound(skipCount, sub ? a - b : a + b, sub ? stepA - stepB : stepA + stepB, INT_MIN, INT_MAX);
+    }
+    for (unsigned i = 0; i < last.storeCount; ++i) {
+        const long long size = 4u >> last.store[i][2];
+        const long long step = toSigned(last.store[i][0] - prev.store[i][0]);
+        if (step % size) {
+            return 0u;
+        }
+        if (flat) {
+            skipCount = bound(skipCount, last.store[i][0], step, 0ll, 1024ll - size);
+        }
+    }
+    return skipCount;
+}
+
+void InstLoopAccel::skip(const unsigned& count, unsigned* state, InstMemory& memory) {
+    const unsigned* newest = this->state[slot(0u)];
+    const unsigned* older = this->state[slot(1u)];
+    for (unsigned i = 0; i < STATE_WORDS; ++i) {
+        state[i] = newest[i] + count * (newest[i] - older[i]);
+    }
+    const InstLoopTrace& last = trace[slot(0u)];
+    const InstLoopTrace& prev = trace[slot(1u)];
+    for (unsigned j = 1; j <= count; ++j) {
+        for (unsigned i = 0; i < last.storeCount; ++i) {
+            const unsigned addr = last.store[i][0] + j * (last.store[i][0] - prev.store[i][0]);
+            const unsigned val = last.store[i][1] + j * (last.store[i][1] - prev.store[i][1]);
+            memory.setMemory(addr, val, static_cast<InstSize>(last.store[i][2]));
+        }
+    }
+    this->count = 0u;
+    backoff = 1u;
+}
+
+bool InstLoopAccel::prove(const InstDataBin* body, const unsigned& len) {
+    if (!len || len > MAX_BODY || !body[len - 1u].isClass(InstClass::BRANCH_I)) {
+        return false;
+    }
+    unsigned written = 0u;
+    for (unsigned i = 0; i + 1u < len; ++i) {
+        written |= body[i].getRegWriteMask();
+    }
+    InstLinearForm form[32];
+    memset(form, 0, sizeof(form));
+    for (unsigned r = 0; r < 32; ++r) {
+        form[r].coef[r] = (written >> r) & 1u;
+    }
+    for (unsigned i = 0; i + 1u < len; ++i) {
+        const InstDataBin& inst = body[i];
+        if (inst.isClass(InstClass::NOP)) {
+            continue;
+        }
+        if (inst.isClass(InstClass::LOAD) || inst.isClass(InstClass::BRANCH) || inst.isClass(InstClass::HALT)) {
+            return false;
+        }
+        const InstLinearForm& rs = form[inst.getRs()];
+        const InstLinearForm& rt = form[inst.getRt()];
+        InstLinearForm result;
+        memset(&result, 0, sizeof(result));
+        switch (static_cast<InstExOp>(inst.getExOp())) {
+            case InstExOp::ADD:
+            case InstExOp::ADDU:
+                for (unsigned r = 0; r < 32; ++r) {
+                    result.coef[r] = rs.coef[r] + rt.coef[r];
+                }
+                break;
+            case InstExOp::SUB:
+                for (unsigned r = 0; r < 32; ++r) {
+                    result.coef[r] = rs.coef[r] - rt.coef[r];
+                }
+                break;
+            case InstExOp::ADDI:
+            case InstExOp::ADDIU:
+            case InstExOp::MEMADDR:
+                result = rs;
+                break;
+            case InstExOp::SLL:
+                for (unsigned r = 0; r < 32; ++r) {
+                    result.coef[r] = rt.coef[r] << inst.getC();
+                }
+                break;
+            case InstExOp::NONE:
+            case InstExOp::ZERO:
+            case InstExOp::LUI:
+                break;
+            default:
+                // not linear, allowed on invariant operands only
+                for (const auto& item : inst.getRegRead()) {
+                    if (!isInvariant(form[item.val])) {
+                        return false;
+                    }
+                }
+                break;
+        }
+        if (static_cast<InstWbOp>(inst.getWbOp()) != InstWbOp::NONE) {
+            if (!inst.getRegWriteMask()) {
+                // writes $0, an error on every iteration
+                return false;
+            }
+            form[inst.getRegWrite().at(0).val] = result;
+        }
+    }
+    // induction: x = x + invariant, derived: a form of induction registers only
+    unsigned induction = 0u;
+    for (unsigned r = 0; r < 32; ++r) {
+        if ((written >> r) & 1u) {
+            InstLinearForm step = form[r];
+            step.coef[r] -= 1u;
+            if (isInvariant(step)) {
+                induction |= 1u << r;
+            }
+        }
+    }
+    for (unsigned r = 0; r < 32; ++r) {
+        if (!((written >> r) & 1u) || ((induction >> r) & 1u)) {
+            continue;
+        }
+        for (unsigned s = 0; s < 32; ++s) {
+            if (form[r].coef[s] && !((induction >> s) & 1u)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool InstLoopAccel::isInvariant(const InstLinearForm& form) {
+    for (unsigned r = 0; r < 32; ++r) {
+        if (form.coef[r]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned InstLoopAccel::slot(const unsigned& age) const {
+    return (head + EDGES - 1u - age) % EDGES;
+}
+
+bool InstLoopAccel::isConsistent() const {
+    const unsigned* oldest = signature[slot(EDGES - 1u)];
+    for (unsigned age = 0; age + 1u < EDGES; ++age) {
+        if (memcmp(signature[slot(age)], oldest, sizeof(unsigned) * SIGNATURE_WORDS)) {
+            return false;
+        }
+    }
+    for (unsigned i = 0; i < STATE_WORDS; ++i) {
+        const unsigned step = state[slot(0u)][i] - state[slot(1u)][i];
+        for (unsigned age = 1; age + 1u < EDGES; ++age) {
+            if (state[slot(age)][i] - state[slot(age + 1u)][i] != step) {
+                return false;
+            }
+        }
+    }
+    // the window ending at the oldest sample may have started anywhere
+    const InstLoopTrace& last = trace[slot(0u)];
+    for (unsigned age = 1; age + 1u < EDGES; ++age) {
+        const InstLoopTrace& prev = trace[slot(age)];
+        const InstLoopTrace& next = trace[slot(age - 1u)];
+        if (prev.full || next.full || prev.opCount != last.opCount || prev.storeCount != last.storeCount) {
+            return false;
+        }
+        for (unsigned i = 0; i < last.opCount; ++i) {
+            if (prev.op[i] != last.op[i] ||
+                next.operand[i][0] - prev.operand[i][0] != last.operand[i][0] - trace[slot(1u)].operand[i][0] ||
+                next.operand[i][1] - prev.operand[i][1] != last.operand[i][1] - trace[slot(1u)].operand[i][1]) {
+                return false;
+            }
+        }
+        for (unsigned i = 0; i < last.storeCount; ++i) {
+            if (prev.store[i][2] != last.store[i][2] ||
+                next.store[i][0] - prev.store[i][0] != last.store[i][0] - trace[slot(1u)].store[i][0] ||
+                next.store[i][1] - prev.store[i][1] != last.store[i][1] - trace[slot(1u)].store[i][1]) {
+                return false;
+            }
+        }
+    }
+    return !last.full;
+}
+
+unsigned InstLoopAccel::getExitCount(const unsigned& branchOp) const {
+    // the branch sits in EX after its back-edge cycle
+    const unsigned rsIndex = STATE_LATCH + 2u * 4u + 2u;
+    const unsigned rtIndex = rsIndex + 1u;
+    const unsigned* newest = state[slot(0u)];
+    const unsigned* older = state[slot(1u)];
+    const unsigned stepRs = newest[rsIndex] - older[rsIndex];
+    const unsigned stepRt = newest[rtIndex] - older[rtIndex];
+    switch (branchOp) {
+        case 0x04u: {
+            // beq, taken while equal
+            return (stepRs == stepRt) ? NONE : 0u;
+        }
+        case 0x05u: {
+            // bne, taken while different
+            const unsigned j = solveZero(newest[rsIndex] - newest[rtIndex], stepRs - stepRt);
+            return (j == NONE) ? NONE : j - 1u;
+        }
+        case 0x07u: {
+            // bgtz, taken while positive
+            return bound(NONE, toSigned(newest[rsIndex]), toSigned(stepRs), 1ll, INT_MAX);
+        }
+        default:
+            return 0u;
+    }
+}
+
+unsigned InstLoopAccel::bound(const unsigned& count, const long long& x, const long long& step,
+                              const long long& lo, const long long& hi) {
+    if (x < lo || x > hi) {
+        return 0u;
+    }
+    if (step > 0) {
+        return static_cast<unsigned>(std::min<long long>(count, (hi - x) / step));
+    }
+    if (step < 0) {
+        return static_cast<unsigned>(std::min<long long>(count, (x - lo) / -step));
+    }
+    return count;
+}
+
+unsigned InstLoopAccel::solveZero(const unsigned& d, const unsigned& step) {
+    if (!step) {
+        return NONE;
+    }
+    unsigned shift = 0u;
+    while (!((step >> shift) & 1u)) {
+        ++shift;
+    }
+    if (d & ((1u << shift) - 1u)) {
+        return NONE;
+    }
+    // j * odd == -d / 2^shift mod 2^(32 - shift), odd inverted by Newton's iteration
+    const unsigned odd = step >> shift;
+    unsigned inverse = odd;
+    for (unsigned i = 0; i < 5u; ++i) {
+        inverse *= 2u - odd * inverse;
+    }
+    const unsigned long long modulus = 1ull << (32u - shift);
+    const unsigned j = static_cast<unsigned>(((0u - d) >> shift) * inverse & (modulus - 1ull));
+    return j ? j : NONE;
+}
+
+} /* namespace lb */
@@ -0,0 +1,185 @@
+/*
+ * InstLoopAccel.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTLOOPACCEL_H_
+#define INSTLOOPACCEL_H_
+
+#include "InstDataBin.h"
+#include "InstMemory.h"
+#include "InstType.h"
+
+namespace lb {
+
+/**
+ * loop accelerator, skips iterations of a loop without simulating their cycles,
+ * a loop is a taken backward beq, bne or bgtz and the straight-line body from its target,
+ * it is skipped only if:
+ *   the body is proved affine: no load, branch or halt, every value is a linear form
+ *   of induction registers(x = x + invariant) and registers derived from them only,
+ *   so every latch, register and store moves by a constant step per iteration;
+ *   four back-edges in a row show the same pipeline signature and constant steps;
+ *   no skipped iteration could raise an error: overflow-checked operands and
+ *   store addresses are bounded analytically, the branch exit is solved exactly.
+ * state at a back-edge is a flat vector, see STATE_*, memory changes are replayed
+ * store by store, no allocation after construction
+ */
+class InstLoopAccel {
+public:
+    constexpr static unsigned MAX_BODY = 64u;
+    // state words: cycle, statistics(cycle, retire, stall, flush), registers,
+    // latches IF to WB of ALUOut, MDR, valRs, valRt
+    constexpr static unsigned STATE_CYCLE = 0u;
+    constexpr static unsigned STATE_STATS = 1u;
+    constexpr static unsigned STATE_REG = 5u;
+    constexpr static unsigned STATE_LATCH = 37u;
+    constexpr static unsigned STATE_WORDS = 57u;
+    // signature words: pc, latches IF to WB of instruction word, pc and flags
+    constexpr static unsigned SIGNATURE_WORDS = 16u;
+
+public:
+    InstLoopAccel();
+
+    virtual ~InstLoopAccel();
+
+    /**
+     * forget the selected loop and its samples
+     */
+    void init();
+
+    bool isSelected(const unsigned& branchPc, const unsigned& target) const;
+
+    /**
+     * select a loop and prove its body, samples restart
+     * @param body instructions from target to the branch, inclusive
+     * @param len number of instructions, at most MAX_BODY
+     */
+    void select(const unsigned& branchPc, const unsigned& target, const InstDataBin* body, const unsigned& len);
+
+    /**
+     * recording operands and stores of the current iteration
+     */
+    bool isTracing() const;
+
+    /**
+     * called on every back-edge of the selected loop
+     * @return false if the edge is not sampled, backing off after a failed skip
+     */
+    bool pollEdge();
+
+    /**
+     * no iteration could be skipped, samples restart after a doubling number of edges
+     */
+    void backOff();
+
+    /**
+     * overflow-checked operands, in execution order
+     */
+    void recordOperands(const int& a, const int& b, const InstOpType& op);
+
+    /**
+     * store performed, in execution order
+     */
+    void recordStore(const unsigned& addr, const unsigned& val, const InstSize& type);
+
+    /**
+     * sample taken at the end of a back-edge cycle of the selected loop
+     * @return true if the last samples agree and getSkipCount() may be asked,
+     *         backs off if they disagree
+     */
+    bool addEdge(const unsigned* state, const unsigned* signature);
+
+    /**
+     * iterations that can be skipped from the last sample
+     * @param branchOp opcode of the back-edge branch
+     * @param flat FLAT memory, store addresses are bounded to it
+     * @param cycleRoom cycles left before the cycle limit
+     */
+    unsigned getSkipCount(const unsigned& branchOp, const bool& flat, const unsigned& cycleRoom) const;
+
+    /**
+     * skip iterations: perform their stores and return the state after them, samples restart
+     * @param count iterations, at most getSkipCount()
+     * @param state written with the state after count iterations
+     */
+    void skip(const unsigned& count, unsigned* state, InstMemory& memory);
+
+private:
+    constexpr static unsigned EDGES = 4u;
+    constexpr static unsigned MAX_OPS = 64u;
+    constexpr static unsigned MAX_STORES = 64u;
+    constexpr static unsigned MAX_BACKOFF = 1024u;
+    constexpr static unsigned NONE = 0xFFFFFFFFu;
+
+private:
+    /**
+     * operands and stores between two back-edges
+     */
+    struct InstLoopTrace {
+        unsigned opCount;
+        unsigned storeCount;
+        // set if a bound was exceeded, the window is unusable
+        bool full;
+        unsigned operand[MAX_OPS][2];
+        InstOpType op[MAX_OPS];
+        unsigned store[MAX_STORES][3];
+    };
+
+    /**
+     * value as a linear form of the registers written in the body,
+     * taken at the start of an iteration, coef mod 2^32, invariant registers fold to constants
+     */
+    struct InstLinearForm {
+        unsigned coef[32];
+    };
+
+private:
+    unsigned branchPc;
+    unsigned target;
+    bool proved;
+    // samples in a ring, slot of the next sample
+    unsigned head;
+    unsigned count;
+    // edges left unsampled, next backoff
+    unsigned idle;
+    unsigned backoff;
+    unsigned state[EDGES][STATE_WORDS];
+    unsigned signature[EDGES][SIGNATURE_WORDS];
+    // trace[i] ends at sample i
+    InstLoopTrace trace[EDGES];
+
+private:
+    static bool prove(const InstDataBin* body, const unsigned& len);
+
+    static bool isInvariant(const InstLinearForm& form);
+
+    /**
+     * slot of the sample age back from the newest
+     */
+    unsigned slot(const unsigned& age) const;
+
+    bool isConsistent() const;
+
+    /**
+     * iterations of the exit branch still taken after the newest sample
+     */
+    unsigned getExitCount(const unsigned& branchOp) const;
+
+    /**
+     * largest count keeping x + j * step in [lo, hi] for j in [0, count]
+     */
+    static unsigned bound(const unsigned& count, const long long& x, const long long& step,
+                          const long long& lo, const long long& hi);
+
+    /**
+     * smallest j >= 1 with d + j * step == 0 mod 2^32, NONE if there is none
+     */
+    static unsigned solveZero(const unsigned& d, const unsigned& step);
+};
+
+} /* namespace lb */
+
+#endif /* INSTLOOPACCEL_H_ */
@@ -6,21 +6,55 @@
  */
 
 #include "InstMemory.h"
+#include "InstAllocCounter.h"
+#include "InstDecodeCache.h"
 
 namespace lb {
 
+constexpr unsigned InstMemory::SIZE_OFFSET[3];
+constexpr unsigned InstMemory::SIZE_MASK[3];
+constexpr unsigned InstMemory::MEMORY_WORDS;
+constexpr unsigned InstMemory::PAGE_WORDS;
+
 InstMemory::InstMemory() {
+    this->model = InstMemoryModel::FLAT;
     memset(this->reg, 0, sizeof(unsigned) * 32);
-    memset(this->mem, 0, sizeof(unsigned char) * 1024);
+    memset(this->mem, 0, sizeof(unsigned) * MEMORY_WORDS);
+    this->directory = nullptr;
+    this->pageCount = 0u;
+    this->lastPage = 0u;
+    this->lastPageData = this->mem;
+    this->lastWritePage = 0u;
+    this->lastWritePageData = this->mem;
+    this->decodeCache = nullptr;
+    this->journal = nullptr;
+    this->journalEpoch = 0u;
+    this->flatEpoch = 0u;
 }
 
 InstMemory::~InstMemory() {
-
+    releasePages();
 }
 
 void InstMemory::init() {
     memset(reg, 0, sizeof(unsigned) * 32);
-    memset(mem, 0, sizeof(unsigned char) * 1024);
+    memset(mem, 0, sizeof(unsigned) * MEMORY_WORDS);
+    resetPages();
+    resetCache();
+}
+
+void InstMemory::setModel(const InstMemoryModel& model) {
+    releasePages();
+    this->model = model;
+    init();
+}
+
+InstMemoryModel InstMemory::getModel() const {
+    return model;
+}
+
+unsigned InstMemory::getPageCount() const {
+    return pageCount;
 }
 
 unsigned InstMemory::getRegister(const unsigned& addr, const InstSize& type) const {
@@ -50,32 +84,236 @@ void InstMemory::setRegister(const unsigned& addr, const unsigned& val, const In
     }
 }
 
-unsigned InstMemory::getMemory(const unsigned& addr, const InstSize& type) const {
-    if (type == InstSize::WORD) {
-        return (mem[addr] << 24) | (mem[addr + 1] << 16) | (mem[addr + 2] << 8) | mem[addr + 3];
+void InstMemory::loadMemory(const unsigned* src, const unsigned& len, const unsigned& addr) {
+    if (model == InstMemoryModel::FLAT) {
+        const unsigned begin = addr >> 2;
+        if (begin < MEMORY_WORDS) {
+            memcpy(mem + begin, src, sizeof(unsigned) * ((len < MEMORY_WORDS - begin) ? len : MEMORY_WORDS - begin));
+        }
+        return;
     }
-    else if (type == InstSize::HALF) {
-        return (mem[addr] << 8) | (mem[addr + 1]);
+    for (unsigned i = 0; i < len;) {
+        const unsigned wordAddr = addr + i * 4u;
+        const unsigned offset = (wordAddr >> 2) & (PAGE_WORDS - 1u);
+        const unsigned n = (len - i < PAGE_WORDS - offset) ? len - i : PAGE_WORDS - offset;
+        InstMemoryPage* page = getPage(wordAddr >> PAGE_BITS);
+        markDirty(page);
+        memcpy(page->word + offset, src + i, sizeof(unsigned) * n);
+        i += n;
     }
-    else {
-        return mem[addr];
+}
+
+void InstMemory::setDecodeCache(InstDecodeCache* decodeCache) {
+    this->decodeCache = decodeCache;
+}
+
+void InstMemory::markCode(const unsigned& addr) {
+    InstMemoryPage* page = getPage(addr >> PAGE_BITS);
+    if (!page->code) {
+        InstAllocCounter::Expected expected;
+        page->code = true;
+        codePages.push_back(page);
+    }
+    if (lastWritePage == (addr >> PAGE_BITS)) {
+        lastWritePage = NO_PAGE;
+        lastWritePageData = nullptr;
     }
 }
 
-void InstMemory::setMemory(const unsigned& addr, const unsigned& val, const InstSize& type) {
-    if (type == InstSize::WORD) {
-        mem[addr] = static_cast<unsigned char>((val >> 24) & 0xFFu);
-        mem[addr + 1] = static_cast<unsigned char>((val >> 16) & 0xFFu);
-        mem[addr + 2] = static_cast<unsigned char>((val >> 8) & 0xFFu);
-        mem[addr + 3] = static_cast<unsigned char>(val & 0xFFu);
+void InstMemory::save(InstCheckpoint& checkpoint) const {
+    checkpoint.writeWord(InstCheckpoint::TAG_MEMORY);
+    checkpoint.writeWords(reg, 32u);
+    if (model == InstMemoryModel::FLAT) {
+        checkpoint.writeWords(mem, MEMORY_WORDS);
+        return;
     }
-    else if (type == InstSize::HALF) {
-        mem[addr] = static_cast<unsigned char>((val >> 8) & 0xFFu);
-        mem[addr + 1] = static_cast<unsigned char>(val & 0xFFu);
+    // pages not written since init() are zero
+    checkpoint.writeWord(static_cast<unsigned>(dirtyPages.size()));
+    for (const InstMemoryPage* page : dirtyPages) {
+        checkpoint.writeWord(page->number);
+        checkpoint.writeWords(page->word, PAGE_WORDS);
+    }
+}
+
+void InstMemory::restore(InstCheckpoint& checkpoint) {
+    init();
+    checkpoint.expect(InstCheckpoint::TAG_MEMORY);
+    checkpoint.readWords(reg, 32u);
+    if (model == InstMemoryModel::FLAT) {
+        checkpoint.readWords(mem, MEMORY_WORDS);
+        return;
+    }
+    const unsigned count = checkpoint.readWord();
+    for (unsigned i = 0; i < count && checkpoint.good(); ++i) {
+        const unsigned number = checkpoint.readWord();
+        if (number >> (TABLE_BITS * 2u)) {
+            checkpoint.fail("corrupted checkpoint");
+            return;
+        }
+        InstMemoryPage* page = getPage(number);
+        markDirty(page);
+        checkpoint.readWords(page->word, PAGE_WORDS);
+    }
+}
+
+void InstMemory::beginJournal(InstMemoryJournal* journal) {
+    this->journal = journal;
+    // pages stamped with an older epoch are copied again on their next store
+    ++journalEpoch;
+    resetCache();
+}
+
+void InstMemory::rollback(const InstMemoryJournal& journal) {
+    for (const InstMemoryJournalPage& saved : journal) {
+        if (model == InstMemoryModel::FLAT) {
+            memcpy(mem, saved.word, sizeof(unsigned) * MEMORY_WORDS);
+            continue;
+        }
+        InstMemoryPage* page = getPage(saved.number);
+        markDirty(page);
+        memcpy(page->word, saved.word, sizeof(unsigned) * PAGE_WORDS);
+        if (page->code && decodeCache) {
+            for (unsigned i = 0; i < PAGE_WORDS; ++i) {
+                decodeCache->invalidate((saved.number << PAGE_BITS) | (i << 2));
+            }
+        }
+    }
+}
+
+bool InstMemory::matchesJournal(const InstMemoryJournal& journal) {
+    for (const InstMemoryJournalPage& saved : journal) {
+        if (model == InstMemoryModel::FLAT) {
+            if (memcmp(mem, saved.word, sizeof(unsigned) * MEMORY_WORDS)) {
+                return false;
+            }
+        }
+        else if (memcmp(getPage(saved.number)->word, saved.word, sizeof(unsigned) * PAGE_WORDS)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned InstMemory::getJournalPage(const unsigned& addr) {
+    return addr >> PAGE_BITS;
+}
+
+InstMemory::InstMemoryPage* InstMemory::getPage(const unsigned& page) {
+    // pages are allocated on first touch, expected at any cycle
+    InstAllocCounter::Expected expected;
+    if (!directory) {
+        directory = new InstMemoryPage**[TABLE_SIZE]();
+    }
+    InstMemoryPage**& table = directory[page >> TABLE_BITS];
+    if (!table) {
+        table = new InstMemoryPage*[TABLE_SIZE]();
+    }
+    InstMemoryPage*& data = table[page & (TABLE_SIZE - 1u)];
+    if (!data) {
+        data = new InstMemoryPage();
+        data->number = page;
+        ++pageCount;
+    }
+    return data;
+}
+
+unsigned* InstMemory::refillPage(const unsigned& addr) {
+    lastPage = addr >> PAGE_BITS;
+    lastPageData = getPage(lastPage)->word;
+    return lastPageData;
+}
+
+unsigned* InstMemory::refillWritePage(const unsigned& addr) {
+    if (model == InstMemoryModel::FLAT) {
+        // write cache is only dropped while journaling
+        if (journal && flatEpoch != journalEpoch) {
+            flatEpoch = journalEpoch;
+            journalPage(0u, mem, MEMORY_WORDS);
+        }
+        lastWritePage = 0u;
+        lastWritePageData = mem;
+        return mem;
+    }
+    InstMemoryPage* page = getPage(addr >> PAGE_BITS);
+    markDirty(page);
+    if (journal && page->epoch != journalEpoch) {
+        page->epoch = journalEpoch;
+        journalPage(page->number, page->word, PAGE_WORDS);
+    }
+    if (page->code) {
+        // code page, not cached, every store invalidates
+        if (decodeCache) {
+            decodeCache->invalidate(addr);
+        }
+        return page->word;
+    }
+    lastWritePage = addr >> PAGE_BITS;
+    lastWritePageData = page->word;
+    return page->word;
+}
+
+void InstMemory::markDirty(InstMemoryPage* page) {
+    if (!page->dirty) {
+        InstAllocCounter::Expected expected;
+        page->dirty = true;
+        dirtyPages.push_back(page);
+    }
+}
+
+void InstMemory::journalPage(const unsigned& number, const unsigned* word, const unsigned& len) {
+    // debugging and the watchdog only, once per page and epoch
+    InstAllocCounter::Expected expected;
+    journal->emplace_back();
+    journal->back().number = number;
+    memcpy(journal->back().word, word, sizeof(unsigned) * len);
+}
+
+void InstMemory::resetPages() {
+    for (InstMemoryPage* page : dirtyPages) {
+        memset(page->word, 0, sizeof(unsigned) * PAGE_WORDS);
+        page->dirty = false;
+    }
+    dirtyPages.clear();
+    for (InstMemoryPage* page : codePages) {
+        page->code = false;
+    }
+    codePages.clear();
+}
+
+void InstMemory::resetCache() {
+    if (model == InstMemoryModel::FLAT) {
+        lastPage = 0u;
+        lastPageData = mem;
+        // journaling needs the first store of an epoch to miss
+        lastWritePage = journal ? NO_PAGE : 0u;
+        lastWritePageData = journal ? nullptr : mem;
     }
     else {
-        mem[addr] = static_cast<unsigned char>(val & 0xFFu);
+        lastPage = NO_PAGE;
+        lastPageData = nullptr;
+        lastWritePage = NO_PAGE;
+        lastWritePageData = nullptr;
+    }
+}
+
+void InstMemory::releasePages() {
+    if (directory) {
+        for (unsigned i = 0; i < TABLE_SIZE; ++i) {
+            if (!directory[i]) {
+                continue;
+            }
+            for (unsigned j = 0; j < TABLE_SIZE; ++j) {
+                delete directory[i][j];
+            }
+            delete[] directory[i];
+        }
+        delete[] directory;
+        directory = nullptr;
     }
+    pageCount = 0u;
+    dirtyPages.clear();
+    codePages.clear();
+    resetCache();
 }
 
 } /* namespace lb */
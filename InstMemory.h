@@ -10,26 +10,64 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
+#include "InstCheckpoint.h"
 #include "InstUtility.h"
 #include "InstType.h"
 
 namespace lb {
 
+class InstDecodeCache;
+
+/**
+ * page copy taken by the undo journal, FLAT memory is page 0
+ */
+struct InstMemoryJournalPage {
+    unsigned number;
+    unsigned word[1024];
+};
+
+typedef std::vector<InstMemoryJournalPage> InstMemoryJournal;
+
 /**
- * memory, 1024 bytes and 32 registers
+ * memory and 32 registers,
+ * FLAT: 1024 bytes, stored as 256 host-endian words
+ * PAGED: 32-bit address space, 4 KiB pages allocated on first access,
+ *        two-level page table, last accessed page cached
+ * UNIFIED: PAGED, also holds instructions, pages with decoded code are flagged
+ *          and a store to them invalidates the decoded instruction
+ * big-endian byte order within a word in both models
  */
 class InstMemory {
 
 public:
     InstMemory();
 
+    InstMemory(const InstMemory& that) = delete;
+
     virtual ~InstMemory();
 
+    InstMemory& operator=(const InstMemory& that) = delete;
+
     /**
-     * initialize
+     * initialize, registers and memory are zero,
+     * only pages written since the last init() are cleared, pages stay allocated
      */
     void init();
 
+    /**
+     * select memory model, release pages, then initialize
+     * @param model FLAT, PAGED or UNIFIED
+     */
+    void setModel(const InstMemoryModel& model);
+
+    InstMemoryModel getModel() const;
+
+    /**
+     * number of pages allocated, 0 for FLAT
+     */
+    unsigned getPageCount() const;
+
     /**
      * get register value at addr
      * @param addr register number to get
@@ -50,7 +88,7 @@ public:
      * @param addr memory address to get
      * @param type load type(WORD, HALF WORD, BYTE)
      */
-    unsigned getMemory(const unsigned& addr, const InstSize& type) const;
+    unsigned getMemory(const unsigned& addr, const InstSize& type);
 
     /**
      * set memory value at addr
@@ -60,11 +98,156 @@ public:
      */
     void setMemory(const unsigned& addr, const unsigned& val, const InstSize& type);
 
+    /**
+     * copy words to memory
+     * @param src words to copy
+     * @param len number of words, FLAT drops extra words past 1024 bytes
+     * @param addr word aligned address of the first word
+     */
+    void loadMemory(const unsigned* src, const unsigned& len, const unsigned& addr = 0u);
+
+    /**
+     * UNIFIED: decoded instructions to invalidate on stores to code pages
+     * @param decodeCache decode cache, nullptr for none
+     */
+    void setDecodeCache(InstDecodeCache* decodeCache);
+
+    /**
+     * UNIFIED: flag the page holding addr as containing decoded code
+     * @param addr instruction address
+     */
+    void markCode(const unsigned& addr);
+
+    /**
+     * write registers and memory, PAGED: only pages written since init()
+     * @param checkpoint checkpoint open for write
+     */
+    void save(InstCheckpoint& checkpoint) const;
+
+    /**
+     * init(), then read registers and memory written by save() in the current model
+     * @param checkpoint checkpoint open for read
+     */
+    void restore(InstCheckpoint& checkpoint);
+
+    /**
+     * start an undo journal, copy-on-write per page:
+     * the first store to a page after this call appends the page to journal first,
+     * only the store cache miss path checks
+     * @param journal page copies, nullptr to stop journaling
+     */
+    void beginJournal(InstMemoryJournal* journal);
+
+    /**
+     * write back the pages of a journal, pass journals newest first to undo several
+     * @param journal journal filled since its beginJournal()
+     */
+    void rollback(const InstMemoryJournal& journal);
+
+    /**
+     * memory is back to its state at the beginJournal() which started journal
+     * @param journal journal filled since its beginJournal()
+     */
+    bool matchesJournal(const InstMemoryJournal& journal);
+
+    /**
+     * journal page number holding addr
+     */
+    static unsigned getJournalPage(const unsigned& addr);
+
+private:
+    constexpr static unsigned MEMORY_WORDS = 256u;
+    constexpr static unsigned PAGE_BITS = 12u;
+    constexpr static unsigned PAGE_WORDS = 1024u;
+    constexpr static unsigned TABLE_BITS = 10u;
+    constexpr static unsigned TABLE_SIZE = 1024u;
+    constexpr static unsigned NO_PAGE = 0xFFFFFFFFu;
+    // indexed by InstSize, byte offset bits within a word and value mask
+    constexpr static unsigned SIZE_OFFSET[3] = {0u, 2u, 3u};
+    constexpr static unsigned SIZE_MASK[3] = {0xFFFFFFFFu, 0x0000FFFFu, 0x000000FFu};
+
+private:
+    /**
+     * PAGED page
+     * number: address >> PAGE_BITS
+     * dirty: written since init(), code: holds decoded instructions(UNIFIED)
+     */
+    struct InstMemoryPage {
+        unsigned word[PAGE_WORDS];
+        unsigned number;
+        // journal epoch the page was last copied in
+        unsigned epoch;
+        bool dirty;
+        bool code;
+    };
+
 private:
-    unsigned char mem[1024];
+    InstMemoryModel model;
+    unsigned mem[MEMORY_WORDS];
     unsigned reg[32];
+    // page table, directory[page >> TABLE_BITS][page & (TABLE_SIZE - 1)], allocated with the first page
+    InstMemoryPage*** directory;
+    unsigned pageCount;
+    unsigned lastPage;
+    unsigned* lastPageData;
+    // stores, never caches a code page, so data-only stores skip the code check
+    unsigned lastWritePage;
+    unsigned* lastWritePageData;
+    // pages with dirty or code set, restored by init()
+    std::vector<InstMemoryPage*> dirtyPages;
+    std::vector<InstMemoryPage*> codePages;
+    InstDecodeCache* decodeCache;
+    InstMemoryJournal* journal;
+    unsigned journalEpoch;
+    unsigned flatEpoch;
+
+private:
+    unsigned& getWord(const unsigned& addr);
+
+    unsigned& getWordForWrite(const unsigned& addr);
+
+    InstMemoryPage* getPage(const unsigned& page);
+
+    unsigned* refillPage(const unsigned& addr);
+
+    unsigned* refillWritePage(const unsigned& addr);
+
+    void markDirty(InstMemoryPage* page);
+
+    void journalPage(const unsigned& number, const unsigned* word, const unsigned& len);
+
+    void resetPages();
+
+    void resetCache();
+
+    void releasePages();
 };
 
+// FLAT keeps mem as the cached page 0, addresses past 1 KiB never reach here
+inline unsigned& InstMemory::getWord(const unsigned& addr) {
+    unsigned* data = ((addr >> PAGE_BITS) == lastPage) ? lastPageData : refillPage(addr);
+    return data[(addr >> 2) & (PAGE_WORDS - 1u)];
+}
+
+inline unsigned& InstMemory::getWordForWrite(const unsigned& addr) {
+    unsigned* data = ((addr >> PAGE_BITS) == lastWritePage) ? lastWritePageData : refillWritePage(addr);
+    return data[(addr >> 2) & (PAGE_WORDS - 1u)];
+}
+
+// addr is aligned and in range, checked by InstErrorDetector before every access,
+// HALF and BYTE are shifted out of the word holding them
+inline unsigned InstMemory::getMemory(const unsigned& addr, const InstSize& type) {
+    const unsigned size = static_cast<unsigned>(type);
+    return (getWord(addr) >> ((~addr & SIZE_OFFSET[size]) << 3)) & SIZE_MASK[size];
+}
+
+inline void InstMemory::setMemory(const unsigned& addr, const unsigned& val, const InstSize& type) {
+    const unsigned size = static_cast<unsigned>(type);
+    const unsigned shift = (~addr & SIZE_OFFSET[size]) << 3;
+    unsigned& word = getWordForWrite(addr);
+    word = (word & ~(SIZE_MASK[size] << shift)) | ((val & SIZE_MASK[size]) << shift);
+}
+
 } /* namespace lb */
 
 #endif /* INSTMEMORY_H_ */
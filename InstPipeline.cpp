@@ -0,0 +1,66 @@
+/*
+ * InstPipeline.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstPipeline.h"
+
+namespace lb {
+
+InstPipeline::InstPipeline() {
+    init();
+}
+
+InstPipeline::~InstPipeline() {
+
+}
+
+void InstPipeline::init() {
+    head = 0u;
+    for (unsigned i = 0; i < InstPipeline::STAGES; ++i) {
+        latch[i] = InstPipelineData::nop;
+    }
+}
+
+InstPipelineData& InstPipeline::at(const unsigned& stage) {
+    return latch[getIndex(stage)];
+}
+
+const InstPipelineData& InstPipeline::at(const unsigned& stage) const {
+    return latch[getIndex(stage)];
+}
+
+void InstPipeline::push(const InstDataBin& inst, const unsigned& instPc) {
+    // old WB slot becomes the new IF slot
+    head = (head == 0u) ? InstPipeline::STAGES - 1 : head - 1;
+    latch[head].reset(inst, instPc);
+}
+
+void InstPipeline::stall() {
+    at(4) = at(3);
+    at(3) = at(2);
+    at(2) = InstPipelineData::nop;
+}
+
+unsigned InstPipeline::getIndex(const unsigned& stage) const {
+    unsigned idx = head + stage;
+    return (idx >= InstPipeline::STAGES) ? idx - InstPipeline::STAGES : idx;
+}
+
+void InstPipeline::save(InstCheckpoint& checkpoint) const {
+    checkpoint.writeWord(InstCheckpoint::TAG_PIPELINE);
+    for (unsigned stage = 0; stage < STAGES; ++stage) {
+        at(stage).save(checkpoint);
+    }
+}
+
+void InstPipeline::restore(InstCheckpoint& checkpoint) {
+    checkpoint.expect(InstCheckpoint::TAG_PIPELINE);
+    for (unsigned stage = 0; stage < STAGES; ++stage) {
+        at(stage).restore(checkpoint);
+    }
+}
+
+} /* namespace lb */
@@ -0,0 +1,84 @@
+/*
+ * InstPipeline.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTPIPELINE_H_
+#define INSTPIPELINE_H_
+
+#include "InstCheckpoint.h"
+#include "InstDataBin.h"
+#include "InstPipelineData.h"
+
+namespace lb {
+
+/**
+ * fixed five-slot pipeline latches(IF, ID, EX, DM, WB)
+ * stage 0 is IF, stage 4 is WB
+ * advancing rotates the head index, no allocation after construction
+ */
+class InstPipeline {
+public:
+    constexpr static unsigned STAGES = 5u;
+
+public:
+    InstPipeline();
+
+    virtual ~InstPipeline();
+
+    /**
+     * fill all latches with nop
+     */
+    void init();
+
+    /**
+     * get latch at stage
+     * @param stage 0(IF) to 4(WB)
+     */
+    InstPipelineData& at(const unsigned& stage);
+
+    /**
+     * get latch at stage
+     * @param stage 0(IF) to 4(WB)
+     */
+    const InstPipelineData& at(const unsigned& stage) const;
+
+    /**
+     * move every latch to next stage, drop WB,
+     * and load a new instruction into IF
+     * @param inst instruction fetched
+     * @param instPc pc of the instruction fetched
+     */
+    void push(const InstDataBin& inst, const unsigned& instPc);
+
+    /**
+     * keep IF, ID latches, move EX, DM to next stage, drop WB,
+     * and inject a bubble(nop) into EX
+     */
+    void stall();
+
+    /**
+     * write latches from IF to WB
+     * @param checkpoint checkpoint open for write
+     */
+    void save(InstCheckpoint& checkpoint) const;
+
+    /**
+     * read latches written by save()
+     * @param checkpoint checkpoint open for read
+     */
+    void restore(InstCheckpoint& checkpoint);
+
+private:
+    InstPipelineData latch[STAGES];
+    unsigned head;
+
+private:
+    unsigned getIndex(const unsigned& stage) const;
+};
+
+} /* namespace lb */
+
+#endif /* INSTPIPELINE_H_ */
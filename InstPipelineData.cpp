@@ -18,7 +18,6 @@ InstPipelineData::InstPipelineData() {
     this->MDR = 0u;
     this->valRs = 0u;
     this->valRt = 0u;
-    this->valC = 0u;
     this->branchResult = false;
     this->stalled = false;
     this->flushed = false;
@@ -31,7 +30,6 @@ InstPipelineData::InstPipelineData(const InstDataBin& inst) {
     this->MDR = 0u;
     this->valRs = 0u;
     this->valRt = 0u;
-    this->valC = inst.getC();
     this->branchResult = false;
     this->stalled = false;
     this->flushed = false;
@@ -44,14 +42,21 @@ InstPipelineData::InstPipelineData(const InstDataBin& inst, const unsigned& inst
     this->MDR = 0u;
     this->valRs = 0u;
     this->valRt = 0u;
-    this->valC = inst.getC();
     this->branchResult = false;
     this->stalled = false;
     this->flushed = false;
 }
 
-InstPipelineData::~InstPipelineData() {
-
+void InstPipelineData::reset(const InstDataBin& inst, const unsigned& instPc) {
+    this->inst = inst;
+    this->instPc = instPc;
+    this->ALUOut = 0u;
+    this->MDR = 0u;
+    this->valRs = 0u;
+    this->valRt = 0u;
+    this->branchResult = false;
+    this->stalled = false;
+    this->flushed = false;
 }
 
 void InstPipelineData::setInstPc(const unsigned& instPc) {
@@ -131,7 +136,7 @@ unsigned InstPipelineData::getValRt() const {
 }
 
 unsigned InstPipelineData::getValC() const {
-    return valC;
+    return inst.getC();
 }
 
 bool InstPipelineData::getBranchResult() const {
@@ -150,4 +155,25 @@ const InstDataBin& InstPipelineData::getInst() const {
     return inst;
 }
 
+void InstPipelineData::save(InstCheckpoint& checkpoint) const {
+    // an undefined opcode decodes without its word, keep it undefined
+    const unsigned flags = (branchResult ? 1u : 0u) | (stalled ? 2u : 0u) | (flushed ? 4u : 0u) |
+                           ((inst.getInstType() == InstType::UNDEF) ? 8u : 0u);
+    const unsigned words[7] = {inst.getInst(), instPc, ALUOut, MDR, valRs, valRt, flags};
+    checkpoint.writeWords(words, 7u);
+}
+
+void InstPipelineData::restore(InstCheckpoint& checkpoint) {
+    unsigned words[7];
+    checkpoint.readWords(words, 7u);
+    reset((words[6] & 8u) ? InstDataBin() : InstDecoder::decodeInstBin(words[0]), words[1]);
+    ALUOut = words[2];
+    MDR = words[3];
+    valRs = words[4];
+    valRt = words[5];
+    branchResult = words[6] & 1u;
+    stalled = words[6] & 2u;
+    flushed = words[6] & 4u;
+}
+
 } /* namespace lb */
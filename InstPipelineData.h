@@ -8,11 +8,15 @@
 #ifndef INSTPIPELINEDATA_H_
 #define INSTPIPELINEDATA_H_
 
+#include "InstCheckpoint.h"
 #include "InstDataBin.h"
 #include "InstDecoder.h"
 
 namespace lb {
 
+/**
+ * pipeline latch, trivially copyable
+ */
 class InstPipelineData {
 public:
     const static InstPipelineData nop;
@@ -24,7 +28,12 @@ public:
 
     InstPipelineData(const InstDataBin& inst, const unsigned& instPc);
 
-    virtual ~InstPipelineData();
+    /**
+     * load a new instruction into this latch, reusing its storage
+     * @param inst instruction
+     * @param instPc pc of the instruction
+     */
+    void reset(const InstDataBin& inst, const unsigned& instPc);
 
     void setInstPc(const unsigned& instPc);
 
@@ -66,6 +75,18 @@ public:
 
     const InstDataBin& getInst() const;
 
+    /**
+     * write instruction word, pc, values and flags
+     * @param checkpoint checkpoint open for write
+     */
+    void save(InstCheckpoint& checkpoint) const;
+
+    /**
+     * read a latch written by save(), the instruction is decoded again
+     * @param checkpoint checkpoint open for read
+     */
+    void restore(InstCheckpoint& checkpoint);
+
 private:
     InstDataBin inst;
     unsigned instPc;
@@ -73,7 +94,6 @@ private:
     unsigned MDR;
     unsigned valRs;
     unsigned valRt;
-    unsigned valC;
     bool branchResult;
     bool stalled;
     bool flushed;
@@ -0,0 +1,177 @@
+/*
+ * InstPolicy.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTPOLICY_H_
+#define INSTPOLICY_H_
+
+#include <cstdio>
+
+namespace lb {
+
+/**
+ * snapshot sink policies,
+ * enabled: write register file and pipeline state every cycle
+ * binary: as InstCycleTrace records instead of snapshot.rpt text
+ */
+class InstSnapshotFile {
+public:
+    constexpr static bool enabled = true;
+    constexpr static bool binary = false;
+};
+
+class InstSnapshotBinary {
+public:
+    constexpr static bool enabled = true;
+    constexpr static bool binary = true;
+};
+
+class InstSnapshotNone {
+public:
+    constexpr static bool enabled = false;
+    constexpr static bool binary = false;
+};
+
+/**
+ * error sink policies,
+ * enabled: write non-fatal errors (write $0, number overflow) and fatal errors,
+ * disabled: non-fatal errors are not detected, fatal errors still halt
+ */
+class InstErrorFile {
+public:
+    constexpr static bool enabled = true;
+};
+
+class InstErrorNone {
+public:
+    constexpr static bool enabled = false;
+};
+
+/**
+ * hazard trace policies,
+ * enabled: record forwarded registers for the fwd_EX-DM annotations
+ */
+class InstHazardTrace {
+public:
+    constexpr static bool enabled = true;
+};
+
+class InstHazardNone {
+public:
+    constexpr static bool enabled = false;
+};
+
+/**
+ * statistics collector policies,
+ * enabled: counters are kept, required by sampled simulation
+ */
+class InstStatsNone {
+public:
+    constexpr static bool enabled = false;
+
+    void init() {}
+
+    void onCycle() {}
+
+    void onRetire() {}
+
+    void onStall() {}
+
+    void onFlush() {}
+
+    unsigned getCycle() const {
+        return 0u;
+    }
+
+    unsigned getRetire() const {
+        return 0u;
+    }
+
+    unsigned getStall() const {
+        return 0u;
+    }
+
+    unsigned getFlush() const {
+        return 0u;
+    }
+
+    void set(const unsigned&, const unsigned&, const unsigned&, const unsigned&) {}
+
+    void report(FILE*) const {}
+};
+
+class InstStatsCounter {
+public:
+    constexpr static bool enabled = true;
+
+    InstStatsCounter() {
+        init();
+    }
+
+    void init() {
+        cycle = 0u;
+        retire = 0u;
+        stall = 0u;
+        flush = 0u;
+    }
+
+    void onCycle() {
+        ++cycle;
+    }
+
+    void onRetire() {
+        ++retire;
+    }
+
+    void onStall() {
+        ++stall;
+    }
+
+    void onFlush() {
+        ++flush;
+    }
+
+    unsigned getCycle() const {
+        return cycle;
+    }
+
+    unsigned getRetire() const {
+        return retire;
+    }
+
+    unsigned getStall() const {
+        return stall;
+    }
+
+    unsigned getFlush() const {
+        return flush;
+    }
+
+    /**
+     * continue counting from restored values
+     */
+    void set(const unsigned& cycle, const unsigned& retire, const unsigned& stall, const unsigned& flush) {
+        this->cycle = cycle;
+        this->retire = retire;
+        this->stall = stall;
+        this->flush = flush;
+    }
+
+    void report(FILE* fp) const {
+        fprintf(fp, "cycles %u, instructions %u, CPI %.3f, stalls %u, flushes %u\n",
+                cycle, retire, retire ? static_cast<double>(cycle) / retire : 0.0, stall, flush);
+    }
+
+private:
+    unsigned cycle;
+    unsigned retire;
+    unsigned stall;
+    unsigned flush;
+};
+
+} /* namespace lb */
+
+#endif /* INSTPOLICY_H_ */
@@ -0,0 +1,51 @@
+/*
+ * InstRender.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "InstCycleTrace.h"
+
+namespace {
+
+void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [TRACE [OUTPUT]]\n", name);
+    fprintf(stderr, "  snapshot.rpt text of a --mode=binary TRACE(snapshot.bin) to OUTPUT(snapshot.rpt),\n"
+            "  - for stdout\n");
+    exit(EXIT_FAILURE);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+    if (argc > 3 || (argc > 1 && argv[1][0] == '-' && argv[1][1])) {
+        usage(argv[0]);
+    }
+    const char* tracePath = (argc > 1) ? argv[1] : "snapshot.bin";
+    const char* outputPath = (argc > 2) ? argv[2] : "snapshot.rpt";
+    FILE* in = fopen(tracePath, "rb");
+    if (!in) {
+        fprintf(stderr, "%s: %s\n", tracePath, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    const bool toStdout = !strcmp(outputPath, "-");
+    FILE* out = toStdout ? stdout : fopen(outputPath, "w");
+    if (!out) {
+        fprintf(stderr, "%s: %s\n", outputPath, strerror(errno));
+        fclose(in);
+        return EXIT_FAILURE;
+    }
+    lb::InstCycleTrace* trace = new lb::InstCycleTrace();
+    bool good = trace->render(in, out, tracePath);
+    delete trace;
+    fclose(in);
+    if (!toStdout) {
+        good = !fclose(out) && good;
+    }
+    return good ? EXIT_SUCCESS : EXIT_FAILURE;
+}
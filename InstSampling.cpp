@@ -0,0 +1,107 @@
+/*
+ * InstSampling.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstSampling.h"
+
+#include <cmath>
+
+namespace lb {
+
+constexpr double InstSampleSet::Z;
+
+InstSampleSet::InstSampleSet() {
+    init();
+}
+
+void InstSampleSet::init() {
+    count = 0u;
+    totalInst = 0ull;
+    cpi.init();
+    stall.init();
+    flush.init();
+}
+
+void InstSampleSet::add(const unsigned& cycles, const unsigned& inst, const unsigned& stalls, const unsigned& flushes) {
+    if (!inst) {
+        return;
+    }
+    ++count;
+    cpi.add(static_cast<double>(cycles) / inst);
+    stall.add(static_cast<double>(stalls) / inst);
+    flush.add(static_cast<double>(flushes) / inst);
+}
+
+void InstSampleSet::setTotalInst(const unsigned long long& totalInst) {
+    this->totalInst = totalInst;
+}
+
+unsigned InstSampleSet::getCount() const {
+    return count;
+}
+
+double InstSampleSet::getCPI() const {
+    return cpi.mean(count);
+}
+
+double InstSampleSet::getCPIError() const {
+    return cpi.halfWidth(count);
+}
+
+void InstSampleSet::report(FILE* fp, const InstSamplingConfig& config) const {
+    fprintf(fp, "sampled %u windows of %u instructions, period %u, %llu instructions\n",
+            count, config.window, config.period, totalInst);
+    if (count < 2u) {
+        fprintf(fp, "too few windows for an estimate, lower the period\n");
+        return;
+    }
+    const double mean = cpi.mean(count);
+    const double error = cpi.halfWidth(count);
+    fprintf(fp, "CPI %.4f +- %.4f (%.2f%%), 99.7%% confidence\n", mean, error, 100.0 * error / mean);
+    fprintf(fp, "stalls/inst %.4f +- %.4f\n", stall.mean(count), stall.halfWidth(count));
+    fprintf(fp, "flushes/inst %.4f +- %.4f\n", flush.mean(count), flush.halfWidth(count));
+    fprintf(fp, "cycles %.0f +- %.0f (estimated)\n", mean * totalInst, error * totalInst);
+    if (error <= config.errorBound * mean) {
+        fprintf(fp, "error bound %.2f%% met\n", 100.0 * config.errorBound);
+        return;
+    }
+    // windows needed: n = (Z * cv / bound)^2, cv from the windows so far
+    const double cv = error * std::sqrt(static_cast<double>(count)) / (Z * mean);
+    const double needed = std::ceil((Z * cv / config.errorBound) * (Z * cv / config.errorBound));
+    const double period = static_cast<double>(totalInst) / needed;
+    if (period < config.warmup + config.window) {
+        fprintf(fp, "error bound %.2f%% not met, about %.0f windows needed, more than the run holds\n",
+                100.0 * config.errorBound, needed);
+        return;
+    }
+    fprintf(fp, "error bound %.2f%% not met, about %.0f windows needed (period about %.0f)\n",
+            100.0 * config.errorBound, needed, period);
+}
+
+void InstSampleSet::InstMoment::init() {
+    sum = 0.0;
+    sumSq = 0.0;
+}
+
+void InstSampleSet::InstMoment::add(const double& x) {
+    sum += x;
+    sumSq += x * x;
+}
+
+double InstSampleSet::InstMoment::mean(const unsigned& n) const {
+    return n ? sum / n : 0.0;
+}
+
+double InstSampleSet::InstMoment::halfWidth(const unsigned& n) const {
+    if (n < 2u) {
+        return 0.0;
+    }
+    const double m = sum / n;
+    const double variance = (sumSq - n * m * m) / (n - 1u);
+    return (variance > 0.0) ? Z * std::sqrt(variance / n) : 0.0;
+}
+
+} /* namespace lb */
@@ -0,0 +1,98 @@
+/*
+ * InstSampling.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTSAMPLING_H_
+#define INSTSAMPLING_H_
+
+#include <cstdio>
+
+namespace lb {
+
+/**
+ * sampled simulation parameters(SMARTS),
+ * every period instructions: fast-forward on the functional core,
+ * then warmup + window instructions in the pipeline, only window is measured
+ */
+struct InstSamplingConfig {
+    unsigned period;
+    unsigned window;
+    unsigned warmup;
+    // relative half width of the confidence interval wanted for CPI
+    double errorBound;
+};
+
+/**
+ * measurements of the detailed windows,
+ * estimates are means over windows with 99.7% (3 sigma) confidence intervals
+ */
+class InstSampleSet {
+public:
+    InstSampleSet();
+
+    void init();
+
+    /**
+     * one measured window
+     * @param cycles cycles of the window
+     * @param inst instructions retired in the window
+     * @param stalls stall cycles
+     * @param flushes branch flushes
+     */
+    void add(const unsigned& cycles, const unsigned& inst, const unsigned& stalls, const unsigned& flushes);
+
+    /**
+     * instructions of the whole run, fast-forwarded and detailed
+     */
+    void setTotalInst(const unsigned long long& totalInst);
+
+    unsigned getCount() const;
+
+    double getCPI() const;
+
+    /**
+     * confidence interval half width of CPI
+     */
+    double getCPIError() const;
+
+    /**
+     * print estimates, intervals and whether errorBound is met
+     * @param fp output file
+     * @param config sampling parameters of the run
+     */
+    void report(FILE* fp, const InstSamplingConfig& config) const;
+
+private:
+    /**
+     * running sums of a per-window rate
+     */
+    struct InstMoment {
+        double sum;
+        double sumSq;
+
+        void init();
+
+        void add(const double& x);
+
+        double mean(const unsigned& n) const;
+
+        double halfWidth(const unsigned& n) const;
+    };
+
+private:
+    constexpr static double Z = 3.0;
+
+private:
+    unsigned count;
+    unsigned long long totalInst;
+    InstMoment cpi;
+    InstMoment stall;
+    InstMoment flush;
+};
+
+} /* namespace lb */
+
+#endif /* INSTSAMPLING_H_ */
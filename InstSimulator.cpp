@@ -5,155 +5,1018 @@
  *      Author: LittleBird
  */
 
+#include <cstdarg>
 #include "InstSimulator.h"
 
 namespace lb {
 
-const unsigned InstSimulator::IF = 0u;
-const unsigned InstSimulator::ID = 1u;
-const unsigned InstSimulator::EX = 2u;
-const unsigned InstSimulator::DM = 3u;
-const unsigned InstSimulator::WB = 4u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::IF = 0u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::ID = 1u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::EX = 2u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::DM = 3u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::WB = 4u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+constexpr unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::SNAPSHOT_BUFFER;
 
-InstSimulator::InstSimulator() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const typename InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::InstStageHandler InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::exHandler[] = {
+        &InstSimulator::instEXNone,    // InstExOp::NONE
+        &InstSimulator::instEXZero,
+        &InstSimulator::instEXAdd,
+        &InstSimulator::instEXAddu,
+        &InstSimulator::instEXSub,
+        &InstSimulator::instEXAnd,     // InstExOp::AND
+        &InstSimulator::instEXOr,
+        &InstSimulator::instEXXor,
+        &InstSimulator::instEXNor,
+        &InstSimulator::instEXNand,
+        &InstSimulator::instEXSlt,     // InstExOp::SLT
+        &InstSimulator::instEXSll,
+        &InstSimulator::instEXSrl,
+        &InstSimulator::instEXSra,
+        &InstSimulator::instEXAddi,
+        &InstSimulator::instEXAddiu,   // InstExOp::ADDIU
+        &InstSimulator::instEXMemAddr,
+        &InstSimulator::instEXLui,
+        &InstSimulator::instEXAndi,
+        &InstSimulator::instEXOri,
+        &InstSimulator::instEXNori,    // InstExOp::NORI
+        &InstSimulator::instEXSlti
+};
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const typename InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::InstStageHandler InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::dmHandler[] = {
+        &InstSimulator::instDMNone,    // InstDmOp::NONE
+        &InstSimulator::instDMLoadWord,
+        &InstSimulator::instDMLoadHalf,
+        &InstSimulator::instDMLoadHalfU,
+        &InstSimulator::instDMLoadByte,
+        &InstSimulator::instDMLoadByteU, // InstDmOp::LBU
+        &InstSimulator::instDMStoreWord,
+        &InstSimulator::instDMStoreHalf,
+        &InstSimulator::instDMStoreByte
+};
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const typename InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::InstStageHandler InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::wbHandler[] = {
+        &InstSimulator::instWBNone,    // InstWbOp::NONE
+        &InstSimulator::instWBALUOut,
+        &InstSimulator::instWBMDR
+};
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::InstSimulator() :
+        functional(memory, decodeCache), loopAccel(nullptr), coSim(nullptr), memoryLatency(1u), heldBuffer(nullptr),
+        cycleTrace(SnapshotSink::binary ? new InstCycleTrace() : nullptr) {
     init();
 }
 
-InstSimulator::~InstSimulator() {
-
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::~InstSimulator() {
+    delete loopAccel;
+    delete coSim;
+    delete[] heldBuffer;
+    delete cycleTrace;
 }
 
-void InstSimulator::init() {
-    pipeline.clear();
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::init() {
+    pipeline.init();
     idForward.clear();
     exForward.clear();
+    stats.init();
     memory.init();
     pcOriginal = 0u;
+    pc = 0u;
+    cycle = 0u;
+    cycleLimit = 0xFFFFFFFFu;
+    alive = true;
     snapshot = nullptr;
     errorDump = nullptr;
-    for (int i = 0; i < InstSimulator::MAXN; ++i) {
-        instList[i] = InstDecoder::decodeInstBin(0u);
+    decodeCache.init();
+    functional.init();
+    // a loaded image would be rolled back into, journaling stops
+    memory.beginJournal(nullptr);
+    history.clear();
+    historyInterval = 1u;
+    haltCycle = 0xFFFFFFFFu;
+    if (loopAccel) {
+        loopAccel->init();
+    }
+    if (coSim) {
+        coSim->init();
+    }
+    skippedCycles = 0u;
+    watchdog.init();
+    watching = false;
+    looping = false;
+    backEdge = false;
+    memoryWait = 0u;
+    if (cycleTrace) {
+        cycleTrace->init();
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::setMemoryModel(const InstMemoryModel& model) {
+    memory.setModel(model);
+    const bool unified = (model == InstMemoryModel::UNIFIED);
+    memory.setDecodeCache(unified ? &decodeCache : nullptr);
+    decodeCache.setMemory(unified ? &memory : nullptr);
+    if (coSim) {
+        coSim->setMemoryModel(model);
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::loadImageI(const unsigned* src, const unsigned& len, const unsigned& pc) {
+    this->pcOriginal = pc;
+    if (coSim) {
+        coSim->loadImageI(src, len, pc);
     }
+    if (memory.getModel() == InstMemoryModel::UNIFIED) {
+        memory.loadMemory(src, len, pc);
+        decodeCache.init();
+    }
+    else {
+        decodeCache.load(src, len, pc);
+    }
+    functional.init();
 }
 
-void InstSimulator::loadImageI(const unsigned* src, const unsigned& len, const unsigned& pc) {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::loadImageI(std::vector<unsigned>&& src, const unsigned& pc) {
     this->pcOriginal = pc;
-    unsigned instSetIdx = pc >> 2;
-    for (unsigned i = 0; i < len; ++i) {
-        instList[instSetIdx] = InstDecoder::decodeInstBin(src[i]);
-        ++instSetIdx;
+    if (coSim) {
+        // before the image is moved
+        coSim->loadImageI(src.data(), static_cast<unsigned>(src.size()), pc);
+    }
+    if (memory.getModel() == InstMemoryModel::UNIFIED) {
+        memory.loadMemory(src.data(), static_cast<unsigned>(src.size()), pc);
+        decodeCache.init();
     }
+    else {
+        decodeCache.load(std::move(src), pc);
+    }
+    functional.init();
 }
 
-void InstSimulator::loadImageD(const unsigned* src, const unsigned& len, const unsigned& sp) {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::loadImageD(const unsigned* src, const unsigned& len, const unsigned& sp) {
     // $sp -> $29
     memory.setRegister(29, sp, InstSize::WORD);
-    for (unsigned i = 0; i < len; ++i) {
-        memory.setMemory(i * 4, src[i], InstSize::WORD);
+    memory.loadMemory(src, len);
+    if (coSim) {
+        coSim->loadImageD(src, len, sp);
     }
 }
 
-void InstSimulator::setLogFile(FILE* snapshot, FILE* errorDump) {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::setLogFile(FILE* snapshot, FILE* errorDump) {
     this->snapshot = snapshot;
     this->errorDump = errorDump;
 }
 
-void InstSimulator::simulate() {
-    if (!snapshot || !errorDump) {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::setMemoryLatency(const unsigned& latency) {
+    memoryLatency = latency ? latency : 1u;
+    memoryWait = 0u;
+    if (SnapshotSink::enabled && !SnapshotSink::binary && memoryLatency > 1u && !heldBuffer) {
+        heldBuffer = new char[SNAPSHOT_BUFFER];
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::simulate(const unsigned& fastForward) {
+    if ((SnapshotSink::enabled && !snapshot) || (ErrorSink::enabled && !errorDump)) {
         fprintf(stderr, "Can\'t open output files\n");
-        return;
+        return true;
     }
     pc = pcOriginal;
     cycle = 0u;
     alive = true;
+    if (fastForward) {
+        functional.init();
+        functional.setLogFile(ErrorSink::enabled ? errorDump : nullptr);
+        runFunctional(fastForward);
+        if (!alive) {
+            return true;
+        }
+    }
+    stats.init();
     // fill pipeline with nop
-    for (int i = 0; i < 5; ++i) {
-        pipeline.push_back(InstPipelineData::nop);
+    pipeline.init();
+    memoryWait = 0u;
+    if (coSim && !fastForward) {
+        coSim->start();
     }
+    const bool finished = simulateLoop();
+    if (coSim) {
+        coSim->flush();
+    }
+    return finished;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::resume() {
+    if ((SnapshotSink::enabled && !snapshot) || (ErrorSink::enabled && !errorDump)) {
+        fprintf(stderr, "Can\'t open output files\n");
+        return true;
+    }
+    if (!alive) {
+        return true;
+    }
+    const bool finished = simulateLoop();
+    if (coSim) {
+        coSim->flush();
+    }
+    return finished;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::simulateLoop() {
+    // allocations after the first cycle, counting builds only
+    unsigned allocBase = 0u;
+    bool allocTaken = false;
     while (!isFinished()) {
-        instWB();
-        instDM();
-        instEX();
-        instID();
-        instIF();
-        instPop();
+        if (cycle == cycleLimit) {
+            return false;
+        }
+        if (memoryWait) {
+            skipHeldCycles();
+            continue;
+        }
+        simulateCycle();
         if (!alive) {
             break;
         }
+        if (looping) {
+            return false;
+        }
+        if (InstAllocCounter::enabled) {
+            checkAllocation(allocBase, allocTaken);
+        }
+    }
+    return true;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::setCycleLimit(const unsigned& limit) {
+    cycleLimit = limit;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::getCycle() const {
+    return cycle;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::setLoopAcceleration(const bool& enabled) {
+    if (!enabled) {
+        delete loopAccel;
+        loopAccel = nullptr;
+    }
+    else if (!loopAccel) {
+        loopAccel = new InstLoopAccel();
+    }
+    backEdge = false;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::getSkippedCycles() const {
+    return skippedCycles;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::setWatchdog(const bool& enabled) {
+    watchdog.init();
+    memory.beginJournal(nullptr);
+    watching = enabled;
+    looping = false;
+    backEdge = false;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isLooping() const {
+    return looping;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::getLoopCycle() const {
+    return watchdog.getRepeatCycle();
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::setCoSimulation(const bool& enabled) {
+    if (!enabled) {
+        delete coSim;
+        coSim = nullptr;
+    }
+    else if (!coSim) {
+        coSim = new InstCoSimulator();
+        coSim->setMemoryModel(memory.getModel());
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::hasDiverged() const {
+    return coSim && coSim->hasDiverged();
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::reportDivergence(FILE* fp) const {
+    if (coSim) {
+        coSim->report(fp);
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::saveCheckpoint(const std::string& filePath) const {
+    InstCheckpoint checkpoint;
+    if (!checkpoint.openWrite(filePath)) {
+        return false;
+    }
+    const unsigned state[11] = {
+        static_cast<unsigned>(memory.getModel()), pcOriginal, pc, cycle, alive ? 1u : 0u,
+        stats.getCycle(), stats.getRetire(), stats.getStall(), stats.getFlush(),
+        memoryLatency, memoryWait
+    };
+    checkpoint.writeWord(InstCheckpoint::TAG_SIMULATOR);
+    checkpoint.writeWords(state, 11u);
+    memory.save(checkpoint);
+    decodeCache.save(checkpoint);
+    pipeline.save(checkpoint);
+    checkpoint.writeWord(InstCheckpoint::TAG_END);
+    return checkpoint.close();
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::restoreCheckpoint(const std::string& filePath) {
+    FILE* snapshotFile = snapshot;
+    FILE* errorDumpFile = errorDump;
+    init();
+    setLogFile(snapshotFile, errorDumpFile);
+    InstCheckpoint checkpoint;
+    if (!checkpoint.openRead(filePath)) {
+        return false;
+    }
+    unsigned state[11];
+    checkpoint.expect(InstCheckpoint::TAG_SIMULATOR);
+    checkpoint.readWords(state, 11u);
+    if (state[0] > static_cast<unsigned>(InstMemoryModel::UNIFIED) || !state[9] || state[10] >= state[9]) {
+        checkpoint.fail("corrupted checkpoint");
+    }
+    if (checkpoint.good()) {
+        setMemoryModel(static_cast<InstMemoryModel>(state[0]));
+        memory.restore(checkpoint);
+        decodeCache.restore(checkpoint);
+        pipeline.restore(checkpoint);
+        checkpoint.expect(InstCheckpoint::TAG_END);
+    }
+    if (!checkpoint.close()) {
+        init();
+        setLogFile(snapshotFile, errorDumpFile);
+        return false;
+    }
+    pcOriginal = state[1];
+    pc = state[2];
+    cycle = state[3];
+    alive = state[4];
+    stats.set(state[5], state[6], state[7], state[8]);
+    setMemoryLatency(state[9]);
+    memoryWait = state[10];
+    return true;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::simulateCycle() {
+    if (memoryWait) {
+        // held for the access in DM, nothing moves
+        --memoryWait;
+        if (SnapshotSink::binary) {
+            if (!cycleTrace->writeHeld(snapshot, 1u)) {
+                // nothing to repeat after a restore, the last snapshot is written in full
+                cycleTrace->write(snapshot, cycle, memory, getHeldPc(), pipeline, idForward, exForward);
+            }
+        }
+        else if (SnapshotSink::enabled) {
+            dumpHeldSnapshot(snapshot);
+        }
+        stats.onCycle();
+        ++cycle;
+        return;
+    }
+    instWB();
+    instDM();
+    instEX();
+    instID();
+    instIF();
+    if (!alive) {
+        return;
+    }
+    if (HazardTrace::enabled) {
         idForward.clear();
         exForward.clear();
-        instSetDependency();
+    }
+    instSetDependency();
+    if (SnapshotSink::binary) {
+        cycleTrace->write(snapshot, cycle, memory, pc, pipeline, idForward, exForward);
+    }
+    else if (SnapshotSink::enabled) {
         dumpSnapshot(snapshot);
-        ++cycle;
-        if (!pipeline.at(IF).isStalled()) {
-            pc += 4;
+    }
+    stats.onCycle();
+    ++cycle;
+    if (!pipeline.at(IF).isStalled()) {
+        pc += 4;
+    }
+    if (memoryLatency > 1u && isMemoryAccess(pipeline.at(DM).getInst())) {
+        memoryWait = memoryLatency - 1u;
+    }
+    if (backEdge) {
+        backEdge = false;
+        onBackEdge();
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::runFunctional(const unsigned& count) {
+    functional.setPc(pc);
+    unsigned executed = 0u;
+    while (functional.isAlive() && !functional.isHalted() && executed < count) {
+        executed += functional.run(count - executed);
+    }
+    // registers and memory are shared, only pc is handed over
+    pc = functional.getPc();
+    alive = functional.isAlive();
+    return executed;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::simulateWindow(const unsigned& warmup,
+        const unsigned& count, InstSampleSet& samples) {
+    pipeline.init();
+    memoryWait = 0u;
+    const unsigned retireBegin = stats.getRetire();
+    unsigned cycleBegin = 0u;
+    unsigned stallBegin = 0u;
+    unsigned flushBegin = 0u;
+    bool measuring = false;
+    while (!isFinished()) {
+        simulateCycle();
+        if (!alive) {
+            break;
+        }
+        const unsigned retired = stats.getRetire() - retireBegin;
+        if (!measuring && retired >= warmup) {
+            measuring = true;
+            cycleBegin = stats.getCycle();
+            stallBegin = stats.getStall();
+            flushBegin = stats.getFlush();
+        }
+        if (retired >= warmup + count) {
+            samples.add(stats.getCycle() - cycleBegin, count, stats.getStall() - stallBegin,
+                        stats.getFlush() - flushBegin);
+            break;
+        }
+    }
+    pc = getResumePc();
+    return stats.getRetire() - retireBegin;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::getResumePc() {
+    // latches have shifted, WB holds an instruction past its memory access,
+    // re-executing it stores the same word or loads the same value
+    for (unsigned stage = WB; stage > IF; --stage) {
+        if (!isNOP(pipeline.at(stage).getInst())) {
+            return pipeline.at(stage).getInstPc();
+        }
+    }
+    return isNOP(pipeline.at(IF).getInst()) ? pc : pipeline.at(IF).getInstPc();
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::checkAllocation(unsigned& allocBase, bool& taken) {
+    if (!taken) {
+        allocBase = InstAllocCounter::getCount();
+        taken = true;
+    }
+    else if (InstAllocCounter::getCount() != allocBase) {
+        fprintf(stderr, "cycle %u: %u heap allocations in the simulation loop\n",
+                cycle - 1u, InstAllocCounter::getCount() - allocBase);
+        abort();
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::simulateFunctional() {
+    if ((SnapshotSink::enabled && !snapshot) || (ErrorSink::enabled && !errorDump)) {
+        fprintf(stderr, "Can\'t open output files\n");
+        return;
+    }
+    functional.init();
+    functional.setLogFile(ErrorSink::enabled ? errorDump : nullptr);
+    functional.setPc(pcOriginal);
+    while (functional.isAlive() && !functional.isHalted()) {
+        functional.run(0xFFFFFFFFu);
+    }
+    pc = functional.getPc();
+    cycle = functional.getInstCount();
+    if (SnapshotSink::enabled && !SnapshotSink::binary) {
+        char buffer[SNAPSHOT_BUFFER];
+        unsigned len = 0u;
+        formatRegister(buffer, len, pc);
+        fprintf(snapshot, "cycle %u\n", cycle);
+        fwrite(buffer, 1u, len, snapshot);
+        fprintf(snapshot, "\n\n");
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::recordTrace(InstTrace& trace,
+        const unsigned& maxInst) {
+    return runTraced(trace, maxInst);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::estimateInterval(InstIntervalModel& model,
+        const unsigned& maxInst) {
+    model.init();
+    model.setMemoryLatency(memoryLatency);
+    return runTraced(model, maxInst);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+template<typename TraceSink>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::runTraced(TraceSink& trace,
+        const unsigned& maxInst) {
+    functional.init();
+    functional.setLogFile(nullptr);
+    functional.setPc(pcOriginal);
+    unsigned count = 0u;
+    unsigned haltRun = 0u;
+    while (haltRun < InstPipeline::STAGES) {
+        if (count == maxInst) {
+            trace.end(InstTraceEnd::LIMIT);
+            return count;
+        }
+        const unsigned instPc = functional.getPc();
+        const InstDataBin& inst = decodeCache.fetch(instPc);
+        // before the instruction writes rs
+        const unsigned addr = memory.getRegister(inst.getRs()) + toUnsigned(toSigned(inst.getC(), 16));
+        const bool stepped = functional.step(inst);
+        ++count;
+        if (!stepped && !functional.isAlive()) {
+            trace.write(instPc, inst, addr, false, true);
+            // in EX and ID when the fault stops the pipeline, their stalls and flushes count
+            unsigned nextPc = instPc + 4;
+            for (unsigned i = 0; i < 2u; ++i) {
+                functional.init();
+                functional.setPc(nextPc);
+                const InstDataBin& next = decodeCache.fetch(nextPc);
+                const unsigned nextAddr = memory.getRegister(next.getRs()) + toUnsigned(toSigned(next.getC(), 16));
+                functional.step(next);
+                trace.write(nextPc, next, nextAddr, functional.isBranchTaken(), false);
+                nextPc = next.isClass(InstClass::BRANCH) ? functional.getPc() : nextPc + 4;
+            }
+            trace.end(InstTraceEnd::FAULT);
+            return count;
+        }
+        trace.write(instPc, inst, addr, functional.isBranchTaken(), false);
+        if (!stepped) {
+            // halt, the pipeline fetches on
+            ++haltRun;
+            functional.setPc(instPc + 4);
+        }
+        else {
+            haltRun = 0u;
+        }
+    }
+    trace.end(InstTraceEnd::HALT);
+    return count;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::simulateSampled(const InstSamplingConfig& config,
+        InstSampleSet& samples) {
+    samples.init();
+    if (!StatsCollector::enabled) {
+        fprintf(stderr, "sampled simulation needs a statistics collector\n");
+        return;
+    }
+    if ((SnapshotSink::enabled && !snapshot) || (ErrorSink::enabled && !errorDump)) {
+        fprintf(stderr, "Can\'t open output files\n");
+        return;
+    }
+    const unsigned detailed = config.warmup + config.window;
+    const unsigned skip = (config.period > detailed) ? config.period - detailed : 0u;
+    unsigned long long totalInst = 0ull;
+    pc = pcOriginal;
+    cycle = 0u;
+    alive = true;
+    stats.init();
+    functional.init();
+    functional.setLogFile(ErrorSink::enabled ? errorDump : nullptr);
+    while (alive) {
+        totalInst += runFunctional(skip);
+        if (!alive || functional.isHalted()) {
+            break;
+        }
+        totalInst += simulateWindow(config.warmup, config.window, samples);
+        if (isFinished()) {
+            break;
+        }
+    }
+    samples.setTotalInst(totalInst);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+const StatsCollector& InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::getStats() const {
+    return stats;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::startDebug(const unsigned& interval, const unsigned& depth) {
+    pc = pcOriginal;
+    cycle = 0u;
+    alive = true;
+    stats.init();
+    pipeline.init();
+    memoryWait = 0u;
+    idForward.clear();
+    exForward.clear();
+    // the history owns the memory journal
+    watching = false;
+    historyInterval = interval ? interval : 1u;
+    haltCycle = 0xFFFFFFFFu;
+    history.init(depth);
+    saveHistory();
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::step() {
+    if (cycle == haltCycle) {
+        // replayed up to the fatal cycle
+        alive = false;
+    }
+    if (!isRunning()) {
+        return false;
+    }
+    if (cycle % historyInterval == 0u && history.at(history.size() - 1u).cycle != cycle) {
+        saveHistory();
+    }
+    InstHistoryEntry& entry = history.at(history.size() - 1u);
+    if (!memoryWait) {
+        entry.regWrites |= pipeline.at(WB).getInst().getRegWriteMask();
+        if (isMemoryStore(pipeline.at(DM).getInst())) {
+            entry.memWrites |= 1u << ((pipeline.at(DM).getALUOut() >> 2) & 31u);
+        }
+    }
+    simulateCycle();
+    if (!alive) {
+        // the fatal cycle left the latches half updated, back to the state before it
+        haltCycle = cycle;
+        loadHistory(history.find(haltCycle));
+        while (cycle < haltCycle && step()) {
+        }
+        alive = false;
+    }
+    return alive;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::gotoCycle(const unsigned& target) {
+    if (target < cycle) {
+        loadHistory(history.find(target));
+    }
+    while (cycle < target && step()) {
+    }
+    if (cycle == haltCycle) {
+        alive = false;
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::findLastRegWrite(const unsigned& reg) {
+    return findLastWrite(&InstSimulator::isRegWriteAt, &InstSimulator::hasRegWrite, reg);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::findLastMemWrite(const unsigned& addr) {
+    return findLastWrite(&InstSimulator::isMemWriteAt, &InstSimulator::hasMemWrite, addr);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isRunning() {
+    return alive && !isFinished();
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isAlive() const {
+    return alive;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::dumpState(FILE* fp) {
+    --cycle;
+    dumpHeldSnapshot(fp);
+    ++cycle;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::peekMemory(const unsigned& addr, unsigned& val) {
+    if (memory.getModel() == InstMemoryModel::FLAT && addr >= 1024u) {
+        return false;
+    }
+    val = memory.getMemory(addr & ~3u, InstSize::WORD);
+    return true;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::saveHistory() {
+    InstHistoryEntry& entry = history.push();
+    entry.cycle = cycle;
+    entry.pc = pc;
+    entry.alive = alive;
+    entry.stats[0] = stats.getCycle();
+    entry.stats[1] = stats.getRetire();
+    entry.stats[2] = stats.getStall();
+    entry.stats[3] = stats.getFlush();
+    for (unsigned i = 0; i < 32; ++i) {
+        entry.reg[i] = memory.getRegister(i);
+    }
+    entry.pipeline = pipeline;
+    entry.idForward = idForward;
+    entry.exForward = exForward;
+    entry.memoryWait = memoryWait;
+    entry.regWrites = 0u;
+    entry.memWrites = 0u;
+    memory.beginJournal(&entry.journal);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::loadHistory(const unsigned& index) {
+    memory.beginJournal(nullptr);
+    // newest first, each journal holds the pages as they were at its checkpoint
+    for (unsigned i = history.size(); i > index; --i) {
+        memory.rollback(history.at(i - 1u).journal);
+    }
+    history.truncate(index);
+    InstHistoryEntry& entry = history.at(index);
+    cycle = entry.cycle;
+    pc = entry.pc;
+    alive = entry.alive;
+    stats.set(entry.stats[0], entry.stats[1], entry.stats[2], entry.stats[3]);
+    for (unsigned i = 0; i < 32; ++i) {
+        memory.setRegister(i, entry.reg[i]);
+    }
+    pipeline = entry.pipeline;
+    idForward = entry.idForward;
+    exForward = entry.exForward;
+    memoryWait = entry.memoryWait;
+    entry.regWrites = 0u;
+    entry.memWrites = 0u;
+    entry.journal.clear();
+    memory.beginJournal(&entry.journal);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::findLastWrite(const InstWriteMatcher match,
+                                                                                      const InstWriteFilter filter,
+                                                                                      const unsigned& arg) {
+    const unsigned now = cycle;
+    if (now < 2u) {
+        return false;
+    }
+    // search cycles before end, newest checkpoint interval first
+    unsigned end = now - 1u;
+    unsigned index = history.find(end - 1u);
+    while (true) {
+        if ((this->*filter)(history.at(index), arg)) {
+            loadHistory(index);
+            unsigned found = 0xFFFFFFFFu;
+            while (cycle < end && isRunning()) {
+                if ((this->*match)(arg)) {
+                    found = cycle;
+                }
+                step();
+            }
+            if (found != 0xFFFFFFFFu) {
+                gotoCycle(found + 1u);
+                return true;
+            }
+        }
+        if (!index) {
+            break;
+        }
+        end = history.at(index).cycle;
+        --index;
+    }
+    gotoCycle(now);
+    return false;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isRegWriteAt(const unsigned& reg) {
+    return !memoryWait && ((pipeline.at(WB).getInst().getRegWriteMask() >> reg) & 1u);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isMemWriteAt(const unsigned& addr) {
+    if (memoryWait) {
+        return false;
+    }
+    const InstPipelineData& pipelineData = pipeline.at(DM);
+    unsigned size = 0u;
+    switch (static_cast<InstDmOp>(pipelineData.getInst().getDmOp())) {
+        case InstDmOp::SW:
+            size = 4u;
+            break;
+        case InstDmOp::SH:
+            size = 2u;
+            break;
+        case InstDmOp::SB:
+            size = 1u;
+            break;
+        default:
+            break;
+    }
+    return addr - pipelineData.getALUOut() < size;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::hasRegWrite(const InstHistoryEntry& entry,
+                                                                                    const unsigned& reg) {
+    return (entry.regWrites >> reg) & 1u;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::hasMemWrite(const InstHistoryEntry& entry,
+                                                                                    const unsigned& addr) {
+    if (!((entry.memWrites >> ((addr >> 2) & 31u)) & 1u)) {
+        return false;
+    }
+    // the journal lists every page stored to in the interval
+    const unsigned number = InstMemory::getJournalPage(addr);
+    for (const InstMemoryJournalPage& page : entry.journal) {
+        if (page.number == number) {
+            return true;
         }
     }
+    return false;
 }
 
-void InstSimulator::dumpSnapshot(FILE* fp) {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::dumpSnapshot(FILE* fp) {
+    char buffer[SNAPSHOT_BUFFER];
     fprintf(fp, "cycle %u\n", cycle);
+    fwrite(buffer, 1u, formatSnapshot(buffer, pc), fp);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::dumpHeldSnapshot(FILE* fp) {
+    char buffer[SNAPSHOT_BUFFER];
+    fprintf(fp, "cycle %u\n", cycle);
+    fwrite(buffer, 1u, formatSnapshot(buffer, getHeldPc()), fp);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::skipHeldCycles() {
+    const unsigned room = cycleLimit - cycle;
+    const unsigned count = (memoryWait < room) ? memoryWait : room;
+    if (SnapshotSink::binary) {
+        if (!cycleTrace->writeHeld(snapshot, count)) {
+            simulateCycle();
+            return;
+        }
+    }
+    else if (SnapshotSink::enabled) {
+        if (!heldBuffer) {
+            // no buffer, one held cycle at a time
+            simulateCycle();
+            return;
+        }
+        // only the cycle line differs, the rest is formatted once
+        const unsigned len = formatSnapshot(heldBuffer, getHeldPc());
+        for (unsigned i = 0; i < count; ++i) {
+            fprintf(snapshot, "cycle %u\n", cycle + i);
+            fwrite(heldBuffer, 1u, len, snapshot);
+        }
+    }
+    memoryWait -= count;
+    cycle += count;
+    stats.set(stats.getCycle() + count, stats.getRetire(), stats.getStall(), stats.getFlush());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::getHeldPc() const {
+    // latches and registers are as in the last snapshot, which was written before pc advanced
+    return pipeline.at(IF).isStalled() ? pc : pc - 4u;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::formatSnapshot(char* buffer,
+        const unsigned& shownPc) {
+    unsigned len = 0u;
+    formatRegister(buffer, len, shownPc);
+    formatText(buffer, len, "IF: 0x%08X", pipeline.at(IF).getInst().getInst());
+    formatPipelineInfo(buffer, len, IF);
+    formatText(buffer, len, "\nID: %s", pipeline.at(ID).getInst().getInstName());
+    formatPipelineInfo(buffer, len, ID);
+    formatText(buffer, len, "\nEX: %s", pipeline.at(EX).getInst().getInstName());
+    formatPipelineInfo(buffer, len, EX);
+    formatText(buffer, len, "\nDM: %s\n", pipeline.at(DM).getInst().getInstName());
+    formatText(buffer, len, "WB: %s\n\n\n", pipeline.at(WB).getInst().getInstName());
+    return len;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::formatRegister(char* buffer, unsigned& len,
+        const unsigned& shownPc) {
+    // fixed width "$%02d: 0x%08X\n" lines, by hand as they are most of every snapshot
+    static const char hex[] = "0123456789ABCDEF";
     for (unsigned i = 0; i < 32; ++i) {
-        fprintf(fp, "$%02d: 0x%08X\n", i, memory.getRegister(i));
-    }
-    fprintf(fp, "PC: 0x%08X\n", pc);
-    fprintf(fp, "IF: 0x%08X", pipeline.at(IF).getInst().getInst());
-    dumpPipelineInfo(fp, IF);
-    fprintf(fp, "\n");
-    fprintf(fp, "ID: %s", pipeline.at(ID).getInst().getInstName().c_str());
-    dumpPipelineInfo(fp, ID);
-    fprintf(fp, "\n");
-    fprintf(fp, "EX: %s", pipeline.at(EX).getInst().getInstName().c_str());
-    dumpPipelineInfo(fp, EX);
-    fprintf(fp, "\n");
-    fprintf(fp, "DM: %s\n", pipeline.at(DM).getInst().getInstName().c_str());
-    fprintf(fp, "WB: %s\n", pipeline.at(WB).getInst().getInstName().c_str());
-    fprintf(fp, "\n\n");
-}
-
-void InstSimulator::dumpPipelineInfo(FILE* fp, const int stage) {
+        char* line = buffer + len;
+        const unsigned val = memory.getRegister(i);
+        line[0] = '$';
+        line[1] = static_cast<char>('0' + i / 10u);
+        line[2] = static_cast<char>('0' + i % 10u);
+        memcpy(line + 3, ": 0x", 4u);
+        for (unsigned j = 0; j < 8u; ++j) {
+            line[7u + j] = hex[(val >> (28u - 4u * j)) & 0xFu];
+        }
+        line[15] = '\n';
+        len += 16u;
+    }
+    formatText(buffer, len, "PC: 0x%08X\n", shownPc);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::formatPipelineInfo(char* buffer, unsigned& len,
+        const int stage) {
     switch (stage) {
         case IF:
             if (pipeline.at(IF).isFlushed()) {
-                fprintf(fp, " to_be_flushed");
+                formatText(buffer, len, " to_be_flushed");
             }
             else if (pipeline.at(IF).isStalled()) {
-                fprintf(fp, " to_be_stalled");
+                formatText(buffer, len, " to_be_stalled");
             }
             break;
         case ID:
             if (pipeline.at(ID).isStalled()) {
-                fprintf(fp, " to_be_stalled");
+                formatText(buffer, len, " to_be_stalled");
             }
             else {
                 for (const auto& item : idForward) {
-                    fprintf(fp, " fwd_EX-DM_%s_$%d", (item.type == InstElementType::RS) ? "rs" : "rt", item.val);
+                    formatText(buffer, len, " fwd_EX-DM_%s_$%d", (item.type == InstElementType::RS) ? "rs" : "rt", item.val);
                 }
             }
             break;
         case EX:
             for (const auto& item : exForward) {
-                fprintf(fp, " fwd_EX-DM_%s_$%d", (item.type == InstElementType::RS) ? "rs" : "rt", item.val);
+                formatText(buffer, len, " fwd_EX-DM_%s_$%d", (item.type == InstElementType::RS) ? "rs" : "rt", item.val);
             }
         default:
             break;
     }
 }
 
-void InstSimulator::instIF() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::formatText(char* buffer, unsigned& len,
+        const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const int count = vsnprintf(buffer + len, SNAPSHOT_BUFFER - len, format, args);
+    va_end(args);
+    if (count > 0) {
+        // a cut text keeps its terminator
+        len = (len + count < SNAPSHOT_BUFFER) ? len + count : SNAPSHOT_BUFFER - 1u;
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instIF() {
     if (pipeline.at(IF).isFlushed()) {
         pipeline.at(IF) = InstPipelineData::nop;
     }
     if (!pipeline.at(IF).isStalled()) {
-        pipeline.push_front(InstPipelineData(instList[pc >> 2], pc));
+        pipeline.push(decodeCache.fetch(pc), pc);
     }
     else {
-        pipeline.insert(pipeline.begin() + 2, InstPipelineData::nop);
+        pipeline.stall();
     }
     instUnstall();
 }
 
-void InstSimulator::instID() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instID() {
     InstPipelineData& pipelineData = pipeline.at(ID);
     const InstDataBin& inst = pipeline.at(ID).getInst();
     if (isNOP(inst) || isHalt(inst) || !isBranch(inst)) {
@@ -173,105 +1036,75 @@ void InstSimulator::instID() {
             }
             pc = ((pipelineData.getInstPc() + 4) & 0xF0000000u) | (pipelineData.getValC() * 4);
         }
+        if ((watching || (!SnapshotSink::enabled && loopAccel)) && pc <= pipelineData.getInstPc()) {
+            backEdge = true;
+        }
     }
 }
 
-void InstSimulator::instEX() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEX() {
     InstPipelineData& pipelineData = pipeline.at(EX);
-    const InstDataBin& inst = pipeline.at(EX).getInst();
-    if (isNOP(inst) || isHalt(inst) || isBranch(inst)) {
-        return;
-    }
-    if (inst.getInstType() == InstType::R) {
-        // type-R, not jr(isBranch)
-        pipelineData.setALUOut(instALUR(inst));
-    }
-    else if (inst.getInstType() == InstType::I) {
-        // type-I, not beq, bne, bgtz(isBranch)
-        pipelineData.setALUOut(instALUI(inst));
-    }
-    else {
-        return;
-    }
+    (this->*exHandler[pipelineData.getInst().getExOp()])(pipelineData);
 }
 
-void InstSimulator::instDM() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDM() {
     InstPipelineData& pipelineData = pipeline.at(DM);
-    const InstDataBin& inst = pipeline.at(DM).getInst();
-    if (isNOP(inst) || isHalt(inst)) {
-        return;
-    }
-    if (isMemoryLoad(inst)) {
-        const unsigned& ALUOut = pipelineData.getALUOut();
-        InstAction action[2];
-        action[0] = detectMemAddrOverflow(ALUOut, inst);
-        action[1] = detectDataMisaligned(ALUOut, inst);
-        if (action[0] == InstAction::HALT || action[1] == InstAction::HALT) {
-            return;
-        }
-        const unsigned& MDR = instMemLoad(ALUOut, inst);
-        pipelineData.setMDR(MDR);
-    }
-    else if (isMemoryStore(inst)) {
-        const unsigned& ALUOut = pipelineData.getALUOut();
-        InstAction action[2];
-        action[0] = detectMemAddrOverflow(ALUOut, inst);
-        action[1] = detectDataMisaligned(ALUOut, inst);
-        if (action[0] == InstAction::HALT || action[1] == InstAction::HALT) {
-            return;
-        }
-        const unsigned& val = memory.getRegister(inst.getRt());
-        instMemStore(ALUOut, val, inst);
-    }
+    (this->*dmHandler[pipelineData.getInst().getDmOp()])(pipelineData);
 }
 
-void InstSimulator::instWB() {
-    const InstPipelineData& pipelineData = pipeline.at(WB);
-    const InstDataBin& inst = pipeline.at(WB).getInst();
-    if (isNOP(inst) || isHalt(inst) || isMemoryStore(inst)) {
-        return;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instWB() {
+    InstPipelineData& pipelineData = pipeline.at(WB);
+    if (!isNOP(pipelineData.getInst())) {
+        stats.onRetire();
     }
-    if (inst.getRegWrite().empty()) {
-        return;
-    }
-    const unsigned& targetAddress = inst.getRegWrite().at(0).val;
-    detectWriteRegZero(targetAddress);
-    if (isMemoryLoad(inst)) {
-        memory.setRegister(targetAddress, pipelineData.getMDR());
-    }
-    else {
-        memory.setRegister(targetAddress, pipelineData.getALUOut());
+    (this->*wbHandler[pipelineData.getInst().getWbOp()])(pipelineData);
+    if (coSim && !isNOP(pipelineData.getInst())) {
+        coSim->retire(pipelineData, memory, cycle);
     }
 }
 
-void InstSimulator::instPop() {
-    pipeline.pop_back();
-}
-
-void InstSimulator::instStall() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instStall() {
     pipeline.at(IF).setStalled(true);
     pipeline.at(ID).setStalled(true);
+    stats.onStall();
 }
 
-void InstSimulator::instUnstall() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instUnstall() {
     pipeline.at(IF).setStalled(false);
     pipeline.at(ID).setStalled(false);
 }
 
-void InstSimulator::instFlush() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instFlush() {
     pipeline.at(IF).setFlushed(true);
+    stats.onFlush();
 }
 
-void InstSimulator::instSetDependency() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instSetDependency() {
+    instSetScoreboard();
     instSetDependencyID();
     instSetDependencyEX();
 }
 
-void InstSimulator::instSetDependencyID() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instSetScoreboard() {
+    for (unsigned stage = EX; stage <= WB; ++stage) {
+        const InstDataBin& inst = pipeline.at(stage).getInst();
+        scoreboardWrite[stage] = inst.getRegWriteMask();
+        scoreboardLoad[stage] = isMemoryLoad(inst) ? scoreboardWrite[stage] : 0u;
+    }
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instSetDependencyID() {
     InstPipelineData& pipelineData = pipeline.at(ID);
     const InstDataBin& inst = pipeline.at(ID).getInst();
-    const std::vector<InstElement>& dmWrite = pipeline.at(DM).getInst().getRegWrite();
-    const std::vector<InstElement>& idRead = pipeline.at(ID).getInst().getRegRead();
     if (isNOP(inst) || isHalt(inst)) {
         return;
     }
@@ -282,42 +1115,24 @@ void InstSimulator::instSetDependencyID() {
     }
     else if (isBranch(inst)) {
         const InstPipelineData& wbData = pipeline.at(WB);
-        if (action == InstState::FORWARD) {
-            for (const auto& item : idRead) {
-                if (!dmWrite.empty() && item.val && item.val == dmWrite.at(0).val) {
-                    pipelineData.setVal(pipeline.at(DM).getALUOut(), item.type);
+        // forward from DM only if there is a dependency on it
+        const unsigned dmForward = (action == InstState::FORWARD) ? scoreboardWrite[DM] : 0u;
+        for (const auto& item : inst.getRegRead()) {
+            const unsigned reg = 1u << item.val;
+            if (reg & dmForward) {
+                pipelineData.setVal(pipeline.at(DM).getALUOut(), item.type);
+                if (HazardTrace::enabled) {
                     idForward.push_back(item);
                 }
-                else {
-                    if (!wbData.getInst().getRegWrite().empty() && item.val &&
-                        wbData.getInst().getRegWrite().at(0).val == item.val) {
-                        if (isMemoryLoad(wbData.getInst())) {
-                            pipelineData.setVal(wbData.getMDR(), item.type);
-                        }
-                        else {
-                            pipelineData.setVal(wbData.getALUOut(), item.type);
-                        }
-                    }
-                    else {
-                        pipelineData.setVal(memory.getRegister(item.val), item.type);
-                    }
-                }
             }
-        }
-        else {
-            for (const auto& item : idRead) {
-                if (!wbData.getInst().getRegWrite().empty() && item.val &&
-                    wbData.getInst().getRegWrite().at(0).val == item.val) {
-                    if (isMemoryLoad(wbData.getInst())) {
-                        pipelineData.setVal(wbData.getMDR(), item.type);
-                    }
-                    else {
-                        pipelineData.setVal(wbData.getALUOut(), item.type);
-                    }
-                }
-                else {
-                    pipelineData.setVal(memory.getRegister(item.val), item.type);
-                }
+            else if (reg & scoreboardLoad[WB]) {
+                pipelineData.setVal(wbData.getMDR(), item.type);
+            }
+            else if (reg & scoreboardWrite[WB]) {
+                pipelineData.setVal(wbData.getALUOut(), item.type);
+            }
+            else {
+                pipelineData.setVal(memory.getRegister(item.val), item.type);
             }
         }
         bool result = instPredictBranch();
@@ -326,23 +1141,21 @@ void InstSimulator::instSetDependencyID() {
             instFlush();
         }
     }
-    else {
-        return;
-    }
 }
 
-void InstSimulator::instSetDependencyEX() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instSetDependencyEX() {
     InstPipelineData& pipelineData = pipeline.at(EX);
     const InstDataBin& inst = pipeline.at(EX).getInst();
-    const std::vector<InstElement>& dmWrite = pipeline.at(DM).getInst().getRegWrite();
-    const std::vector<InstElement>& exRead = pipeline.at(EX).getInst().getRegRead();
     if (isNOP(inst) || isHalt(inst) || isBranch(inst)) {
         return;
     }
-    for (const auto& item : exRead) {
-        if (!dmWrite.empty() && item.val && item.val == dmWrite.at(0).val) {
+    for (const auto& item : inst.getRegRead()) {
+        if ((1u << item.val) & scoreboardWrite[DM]) {
             pipelineData.setVal(pipeline.at(DM).getALUOut(), item.type);
-            exForward.push_back(item);
+            if (HazardTrace::enabled) {
+                exForward.push_back(item);
+            }
         }
         else {
             pipelineData.setVal(memory.getRegister(item.val), item.type);
@@ -350,7 +1163,8 @@ void InstSimulator::instSetDependencyEX() {
     }
 }
 
-bool InstSimulator::instPredictBranch() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instPredictBranch() {
     const InstPipelineData& pipelineData = pipeline.at(ID);
     const InstDataBin& inst = pipeline.at(ID).getInst();
     if (isBranchR(inst)) {
@@ -379,126 +1193,256 @@ bool InstSimulator::instPredictBranch() {
     }
 }
 
-unsigned InstSimulator::instALUR(const InstDataBin& inst) {
-    const InstPipelineData& pipelineData = pipeline.at(EX);
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+unsigned InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instALUJ(const unsigned& instPc) {
+    return instPc + 4;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXNone(InstPipelineData&) {
+
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXZero(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(0u);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXAdd(InstPipelineData& pipelineData) {
     const unsigned& valRs = pipelineData.getValRs();
     const unsigned& valRt = pipelineData.getValRt();
-    const unsigned& valC = pipelineData.getValC();
-    detectNumberOverflow(toSigned(valRs), toSigned(valRt), inst);
-    switch (inst.getFunct()) {
-        case 0x20u: // add
-            return valRs + valRt;
-        case 0x21u: // addu
-            return valRs + valRt;
-        case 0x22u: // sub
-            return valRs - valRt;
-        case 0x24u: // and
-            return valRs & valRt;
-        case 0x25u: // or
-            return valRs | valRt;
-        case 0x26u: // xor
-            return valRs ^ valRt;
-        case 0x27u: // nor
-            return ~(valRs | valRt);
-        case 0x28u: // nand
-            return ~(valRs & valRt);
-        case 0x2Au: // slt
-            return static_cast<unsigned>(toSigned(valRs) < toSigned(valRt));
-        case 0x00u: // sll
-            return valRt << valC;
-        case 0x02u: // srl
-            return valRt >> valC;
-        case 0x03u: // sra
-            return static_cast<unsigned>(static_cast<int>(valRt) >> static_cast<int>(valC));
-        default:
-            return 0u;
-    }
+    detectNumberOverflow(toSigned(valRs), toSigned(valRt), InstOpType::ADD);
+    pipelineData.setALUOut(valRs + valRt);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXAddu(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRs() + pipelineData.getValRt());
 }
 
-unsigned InstSimulator::instALUI(const InstDataBin& inst) {
-    const InstPipelineData& pipelineData = pipeline.at(EX);
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXSub(InstPipelineData& pipelineData) {
     const unsigned& valRs = pipelineData.getValRs();
-    const unsigned& valC = pipelineData.getValC();
-    detectNumberOverflow(toSigned(valRs), toSigned(valC, 16), inst);
-    switch (inst.getOpCode()) {
-        case 0x08u: // addi
-            return toUnsigned(toSigned(valRs) + toSigned(valC, 16));
-        case 0x09u: // addiu
-            return valRs + toUnsigned(toSigned(valC, 16));
-        case 0x23u: // lw
-        case 0x21u: // lh
-        case 0x25u: // lhu
-        case 0x20u: // lb
-        case 0x24u: // lbu
-        case 0x2Bu: // sw
-        case 0x29u: // sh
-        case 0x28u: // sb
-            return toUnsigned(toSigned(valRs) + toSigned(valC, 16));
-        case 0x0Fu: // lui // special // maybe incorrect
-            return valC << 16;
-        case 0x0Cu: // andi
-            return valRs & valC;
-        case 0x0Du: // ori
-            return valRs | valC;
-        case 0x0Eu: // nori
-            return ~(valRs | valC);
-        case 0x0Au: // slti
-            return static_cast<unsigned>(toSigned(valRs) < toSigned(valC, 16));
-        default:
-            return 0u;
+    const unsigned& valRt = pipelineData.getValRt();
+    detectNumberOverflow(toSigned(valRs), toSigned(valRt), InstOpType::SUB);
+    pipelineData.setALUOut(valRs - valRt);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXAnd(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRs() & pipelineData.getValRt());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXOr(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRs() | pipelineData.getValRt());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXXor(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRs() ^ pipelineData.getValRt());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXNor(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(~(pipelineData.getValRs() | pipelineData.getValRt()));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXNand(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(~(pipelineData.getValRs() & pipelineData.getValRt()));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXSlt(InstPipelineData& pipelineData) {
+    const int valRs = toSigned(pipelineData.getValRs());
+    const int valRt = toSigned(pipelineData.getValRt());
+    pipelineData.setALUOut(static_cast<unsigned>(valRs < valRt));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXSll(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRt() << pipelineData.getValC());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXSrl(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRt() >> pipelineData.getValC());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXSra(InstPipelineData& pipelineData) {
+    const int valRt = toSigned(pipelineData.getValRt());
+    pipelineData.setALUOut(static_cast<unsigned>(valRt >> static_cast<int>(pipelineData.getValC())));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXAddi(InstPipelineData& pipelineData) {
+    const unsigned& valRs = pipelineData.getValRs();
+    const int valC = toSigned(pipelineData.getValC(), 16);
+    detectNumberOverflow(toSigned(valRs), valC, InstOpType::ADD);
+    pipelineData.setALUOut(valRs + toUnsigned(valC));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXAddiu(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRs() + toUnsigned(toSigned(pipelineData.getValC(), 16)));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXMemAddr(InstPipelineData& pipelineData) {
+    // lw, lh, lhu, lb, lbu, sw, sh, sb
+    const unsigned& valRs = pipelineData.getValRs();
+    const int valC = toSigned(pipelineData.getValC(), 16);
+    detectNumberOverflow(toSigned(valRs), valC, InstOpType::ADD);
+    pipelineData.setALUOut(valRs + toUnsigned(valC));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXLui(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValC() << 16);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXAndi(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRs() & pipelineData.getValC());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXOri(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(pipelineData.getValRs() | pipelineData.getValC());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXNori(InstPipelineData& pipelineData) {
+    pipelineData.setALUOut(~(pipelineData.getValRs() | pipelineData.getValC()));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instEXSlti(InstPipelineData& pipelineData) {
+    const int valRs = toSigned(pipelineData.getValRs());
+    const int valC = toSigned(pipelineData.getValC(), 16);
+    pipelineData.setALUOut(static_cast<unsigned>(valRs < valC));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMNone(InstPipelineData&) {
+
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMLoadWord(InstPipelineData& pipelineData) {
+    const unsigned& addr = pipelineData.getALUOut();
+    if (detectMemAccess(addr, InstSize::WORD) == InstAction::HALT) {
+        return;
     }
+    pipelineData.setMDR(memory.getMemory(addr, InstSize::WORD));
 }
 
-unsigned InstSimulator::instALUJ(const unsigned& instPc) {
-    return instPc + 4;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMLoadHalf(InstPipelineData& pipelineData) {
+    const unsigned& addr = pipelineData.getALUOut();
+    if (detectMemAccess(addr, InstSize::HALF) == InstAction::HALT) {
+        return;
+    }
+    pipelineData.setMDR(toUnsigned(toSigned(memory.getMemory(addr, InstSize::HALF), InstSize::HALF)));
 }
 
-unsigned InstSimulator::instMemLoad(const unsigned& addr, const InstDataBin& inst) {
-    switch (inst.getOpCode()) {
-        case 0x23u:
-            return memory.getMemory(addr, InstSize::WORD);
-        case 0x21u:
-            return toUnsigned(toSigned(memory.getMemory(addr, InstSize::HALF), InstSize::HALF));
-        case 0x25u:
-            return memory.getMemory(addr, InstSize::HALF);
-        case 0x20u:
-            return toUnsigned(toSigned(memory.getMemory(addr, InstSize::BYTE), InstSize::BYTE));
-        case 0x24u:
-            return memory.getMemory(addr, InstSize::BYTE);
-        default:
-            return 0u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMLoadHalfU(InstPipelineData& pipelineData) {
+    const unsigned& addr = pipelineData.getALUOut();
+    if (detectMemAccess(addr, InstSize::HALF) == InstAction::HALT) {
+        return;
     }
+    pipelineData.setMDR(memory.getMemory(addr, InstSize::HALF));
 }
 
-void InstSimulator::instMemStore(const unsigned& addr, const unsigned& val, const InstDataBin& inst) {
-    switch (inst.getOpCode()) {
-        case 0x2Bu:
-            memory.setMemory(addr, val, InstSize::WORD);
-            return;
-        case 0x29u:
-            memory.setMemory(addr, val, InstSize::HALF);
-            return;
-        case 0x28u:
-            memory.setMemory(addr, val, InstSize::BYTE);
-            return;
-        default:
-            return;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMLoadByte(InstPipelineData& pipelineData) {
+    const unsigned& addr = pipelineData.getALUOut();
+    if (detectMemAccess(addr, InstSize::BYTE) == InstAction::HALT) {
+        return;
     }
+    pipelineData.setMDR(toUnsigned(toSigned(memory.getMemory(addr, InstSize::BYTE), InstSize::BYTE)));
 }
 
-bool InstSimulator::isNOP(const InstDataBin& inst) {
-    return !inst.getOpCode() &&
-           !inst.getRt() &&
-           !inst.getRd() &&
-           !inst.getC() &&
-           !inst.getFunct();
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMLoadByteU(InstPipelineData& pipelineData) {
+    const unsigned& addr = pipelineData.getALUOut();
+    if (detectMemAccess(addr, InstSize::BYTE) == InstAction::HALT) {
+        return;
+    }
+    pipelineData.setMDR(memory.getMemory(addr, InstSize::BYTE));
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMStoreWord(InstPipelineData& pipelineData) {
+    const unsigned& addr = pipelineData.getALUOut();
+    if (detectMemAccess(addr, InstSize::WORD) == InstAction::HALT) {
+        return;
+    }
+    if (!SnapshotSink::enabled && loopAccel && loopAccel->isTracing()) {
+        loopAccel->recordStore(addr, memory.getRegister(pipelineData.getInst().getRt()), InstSize::WORD);
+    }
+    memory.setMemory(addr, memory.getRegister(pipelineData.getInst().getRt()), InstSize::WORD);
 }
 
-bool InstSimulator::isHalt(const InstDataBin& inst) {
-    return inst.getOpCode() == 0x3Fu;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMStoreHalf(InstPipelineData& pipelineData) {
+    const unsigned& addr = pipelineData.getALUOut();
+    if (detectMemAccess(addr, InstSize::HALF) == InstAction::HALT) {
+        return;
+    }
+    if (!SnapshotSink::enabled && loopAccel && loopAccel->isTracing()) {
+        loopAccel->recordStore(addr, memory.getRegister(pipelineData.getInst().getRt()), InstSize::HALF);
+    }
+    memory.setMemory(addr, memory.getRegister(pipelineData.getInst().getRt()), InstSize::HALF);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instDMStoreByte(InstPipelineData& pipelineData) {
+    const unsigned& addr = pipelineData.getALUOut();
+    if (detectMemAccess(addr, InstSize::BYTE) == InstAction::HALT) {
+        return;
+    }
+    if (!SnapshotSink::enabled && loopAccel && loopAccel->isTracing()) {
+        loopAccel->recordStore(addr, memory.getRegister(pipelineData.getInst().getRt()), InstSize::BYTE);
+    }
+    memory.setMemory(addr, memory.getRegister(pipelineData.getInst().getRt()), InstSize::BYTE);
 }
 
-bool InstSimulator::isFinished() {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instWBNone(InstPipelineData&) {
+
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instWBALUOut(InstPipelineData& pipelineData) {
+    const unsigned& targetAddress = pipelineData.getInst().getRegWrite().at(0).val;
+    detectWriteRegZero(targetAddress);
+    memory.setRegister(targetAddress, pipelineData.getALUOut());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::instWBMDR(InstPipelineData& pipelineData) {
+    const unsigned& targetAddress = pipelineData.getInst().getRegWrite().at(0).val;
+    detectWriteRegZero(targetAddress);
+    memory.setRegister(targetAddress, pipelineData.getMDR());
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isNOP(const InstDataBin& inst) {
+    return inst.isClass(InstClass::NOP);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isHalt(const InstDataBin& inst) {
+    return inst.isClass(InstClass::HALT);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isFinished() {
     return isHalt(pipeline.at(0).getInst()) &&
            isHalt(pipeline.at(1).getInst()) &&
            isHalt(pipeline.at(2).getInst()) &&
@@ -506,231 +1450,236 @@ bool InstSimulator::isFinished() {
            isHalt(pipeline.at(4).getInst());
 }
 
-bool InstSimulator::isMemoryLoad(const InstDataBin& inst) {
-    switch (inst.getOpCode()) {
-        case 0x23u:
-        case 0x21u:
-        case 0x25u:
-        case 0x20u:
-        case 0x24u:
-            return true;
-        default:
-            return false;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::onBackEdge() {
+    if (watching) {
+        unsigned state[InstWatchdog::STATE_WORDS];
+        state[0] = pc;
+        for (unsigned i = 0; i < 32; ++i) {
+            state[1u + i] = memory.getRegister(i);
+        }
+        for (unsigned stage = IF; stage <= WB; ++stage) {
+            const InstPipelineData& pipelineData = pipeline.at(stage);
+            unsigned* latch = state + 33u + stage * 7u;
+            latch[0] = pipelineData.getInst().getInst();
+            latch[1] = pipelineData.getInstPc();
+            latch[2] = pipelineData.getALUOut();
+            latch[3] = pipelineData.getMDR();
+            latch[4] = pipelineData.getValRs();
+            latch[5] = pipelineData.getValRt();
+            latch[6] = (pipelineData.getBranchResult() ? 1u : 0u) |
+                       (pipelineData.isStalled() ? 2u : 0u) | (pipelineData.isFlushed() ? 4u : 0u);
+        }
+        if (watchdog.addEdge(state, cycle, memory)) {
+            looping = true;
+            return;
+        }
+    }
+    if (!SnapshotSink::enabled && loopAccel && isBranchI(pipeline.at(EX).getInst())) {
+        onLoopEdge();
     }
 }
 
-bool InstSimulator::isMemoryStore(const InstDataBin& inst) {
-    switch (inst.getOpCode()) {
-        case 0x2Bu:
-        case 0x29u:
-        case 0x28u:
-            return true;
-        default:
-            return false;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+void InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::onLoopEdge() {
+    const InstPipelineData& branch = pipeline.at(EX);
+    const unsigned target = pipeline.at(IF).getInstPc();
+    if (!alive || memory.getModel() == InstMemoryModel::UNIFIED) {
+        return;
+    }
+    if (!loopAccel->isSelected(branch.getInstPc(), target)) {
+        const unsigned len = (branch.getInstPc() - target) / 4u + 1u;
+        InstDataBin body[InstLoopAccel::MAX_BODY];
+        for (unsigned i = 0; i < len && i < InstLoopAccel::MAX_BODY; ++i) {
+            body[i] = decodeCache.fetch(target + i * 4u);
+        }
+        loopAccel->select(branch.getInstPc(), target, body, (len <= InstLoopAccel::MAX_BODY) ? len : 0u);
+    }
+    if (!loopAccel->pollEdge()) {
+        return;
+    }
+    unsigned state[InstLoopAccel::STATE_WORDS];
+    unsigned signature[InstLoopAccel::SIGNATURE_WORDS];
+    state[InstLoopAccel::STATE_CYCLE] = cycle;
+    state[InstLoopAccel::STATE_STATS] = stats.getCycle();
+    state[InstLoopAccel::STATE_STATS + 1u] = stats.getRetire();
+    state[InstLoopAccel::STATE_STATS + 2u] = stats.getStall();
+    state[InstLoopAccel::STATE_STATS + 3u] = stats.getFlush();
+    for (unsigned i = 0; i < 32; ++i) {
+        state[InstLoopAccel::STATE_REG + i] = memory.getRegister(i);
+    }
+    signature[0] = pc;
+    for (unsigned stage = IF; stage <= WB; ++stage) {
+        const InstPipelineData& pipelineData = pipeline.at(stage);
+        unsigned* latch = state + InstLoopAccel::STATE_LATCH + stage * 4u;
+        latch[0] = pipelineData.getALUOut();
+        latch[1] = pipelineData.getMDR();
+        latch[2] = pipelineData.getValRs();
+        latch[3] = pipelineData.getValRt();
+        signature[1u + stage * 3u] = pipelineData.getInst().getInst();
+        signature[2u + stage * 3u] = pipelineData.getInstPc();
+        signature[3u + stage * 3u] = (pipelineData.getBranchResult() ? 1u : 0u) |
+                                     (pipelineData.isStalled() ? 2u : 0u) | (pipelineData.isFlushed() ? 4u : 0u);
+    }
+    if (!loopAccel->addEdge(state, signature)) {
+        return;
+    }
+    const unsigned count = loopAccel->getSkipCount(branch.getInst().getOpCode(),
+                                                   memory.getModel() == InstMemoryModel::FLAT, cycleLimit - cycle);
+    if (!count) {
+        loopAccel->backOff();
+        return;
+    }
+    loopAccel->skip(count, state, memory);
+    skippedCycles += state[InstLoopAccel::STATE_CYCLE] - cycle;
+    cycle = state[InstLoopAccel::STATE_CYCLE];
+    stats.set(state[InstLoopAccel::STATE_STATS], state[InstLoopAccel::STATE_STATS + 1u],
+              state[InstLoopAccel::STATE_STATS + 2u], state[InstLoopAccel::STATE_STATS + 3u]);
+    for (unsigned i = 1; i < 32; ++i) {
+        memory.setRegister(i, state[InstLoopAccel::STATE_REG + i], InstSize::WORD);
+    }
+    for (unsigned stage = IF; stage <= WB; ++stage) {
+        InstPipelineData& pipelineData = pipeline.at(stage);
+        const unsigned* latch = state + InstLoopAccel::STATE_LATCH + stage * 4u;
+        pipelineData.setALUOut(latch[0]);
+        pipelineData.setMDR(latch[1]);
+        pipelineData.setValRs(latch[2]);
+        pipelineData.setValRt(latch[3]);
     }
 }
 
-bool InstSimulator::isBranch(const InstDataBin& inst) {
-    return isBranchR(inst) ||
-           isBranchI(inst) ||
-           isBranchJ(inst);
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isMemoryLoad(const InstDataBin& inst) {
+    return inst.isClass(InstClass::LOAD);
 }
 
-bool InstSimulator::isBranchR(const InstDataBin& inst) {
-    return inst.getInstType() == InstType::R && inst.getFunct() == 0x08u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isMemoryStore(const InstDataBin& inst) {
+    return inst.isClass(InstClass::STORE);
 }
 
-bool InstSimulator::isBranchI(const InstDataBin& inst) {
-    if (inst.getInstType() != InstType::I) {
-        return false;
-    }
-    return inst.getOpCode() == 0x04u || inst.getOpCode() == 0x05u || inst.getOpCode() == 0x07u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isMemoryAccess(const InstDataBin& inst) {
+    return inst.isClass(InstClass::LOAD) || inst.isClass(InstClass::STORE);
 }
 
-bool InstSimulator::isBranchJ(const InstDataBin& inst) {
-    if (inst.getInstType() != InstType::J) {
-        return false;
-    }
-    return inst.getOpCode() == 0x02u || inst.getOpCode() == 0x03u;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isBranch(const InstDataBin& inst) {
+    return inst.isClass(InstClass::BRANCH);
 }
 
-bool InstSimulator::hasToStall(const unsigned& dependency, const std::vector<unsigned>& dEX,
-                               const std::vector<unsigned>& dDM) {
-    const InstDataBin& inst = pipeline.at(ID).getInst();
-    // no dependency
-    if (dependency == 0u) {
-        return false;
-    }
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isBranchR(const InstDataBin& inst) {
+    return inst.isClass(InstClass::BRANCH_R);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isBranchI(const InstDataBin& inst) {
+    return inst.isClass(InstClass::BRANCH_I);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::isBranchJ(const InstDataBin& inst) {
+    return inst.isClass(InstClass::BRANCH_J);
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+bool InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::hasToStall(const unsigned& dEX, const unsigned& dDM) {
     // load memory -> stall
-    if (!dEX.empty() && isMemoryLoad(pipeline.at(EX).getInst())) {
-        return true;
-    }
-    if (!dDM.empty() && isMemoryLoad(pipeline.at(DM).getInst())) {
+    if ((dEX & scoreboardLoad[EX]) || (dDM & scoreboardLoad[DM])) {
         return true;
     }
     // depends on both ex, dm
-    if (!dEX.empty() && !dDM.empty()) {
+    if (dEX && dDM) {
         return true;
     }
-    if (isBranch(inst)) {
-        return !dEX.empty();
+    if (isBranch(pipeline.at(ID).getInst())) {
+        return dEX != 0u;
     }
     else {
-        return !dDM.empty();
+        return dDM != 0u;
     }
 }
 
-unsigned InstSimulator::getDependency(std::vector<unsigned>& dEX, std::vector<unsigned>& dDM) {
-    // return 0: no dependency,
-    // & (1u << EX) == 1: on ex
-    // & (1u << DM) == 1: on dm
-    const std::vector<InstElement>& exWrite = pipeline.at(EX).getInst().getRegWrite();
-    const std::vector<InstElement>& dmWrite = pipeline.at(DM).getInst().getRegWrite();
-    const std::vector<InstElement>& idRead = pipeline.at(ID).getInst().getRegRead();
-    unsigned stage = 0u;
-    for (const auto& item : idRead) {
-        if (!exWrite.empty() && item.val && item.val == exWrite.at(0).val) {
-            stage |= (1u << EX);
-            dEX.push_back(item.val);
-        }
-        else if (!dmWrite.empty() && item.val && item.val == dmWrite.at(0).val) {
-            stage |= (1u << DM);
-            dDM.push_back(item.val);
-        }
-    }
-    return stage;
-}
-
-InstState InstSimulator::checkIDDependency() {
-    std::vector<unsigned> dEX;
-    std::vector<unsigned> dDM;
-    unsigned dependency = getDependency(dEX, dDM);
-    if (dependency == 0u) {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+InstState InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::checkIDDependency() {
+    // a register written by both EX and DM depends on EX only
+    const unsigned idRead = pipeline.at(ID).getInst().getRegReadMask();
+    const unsigned dEX = idRead & scoreboardWrite[EX];
+    const unsigned dDM = idRead & scoreboardWrite[DM] & ~scoreboardWrite[EX];
+    if (!dEX && !dDM) {
         return InstState::NONE;
     }
+    else if (hasToStall(dEX, dDM)) {
+        return InstState::STALL;
+    }
     else {
-        bool stall = hasToStall(dependency, dEX, dDM);
-        if (stall) {
-            return InstState::STALL;
-        }
-        else {
-            return InstState::FORWARD;
-        }
+        return InstState::FORWARD;
     }
 }
 
-InstAction InstSimulator::detectWriteRegZero(const unsigned& addr) {
-    if (!InstErrorDetector::isRegWritable(addr)) {
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+InstAction InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::detectWriteRegZero(const unsigned& addr) {
+    if (ErrorSink::enabled && !InstErrorDetector::isRegWritable(addr)) {
         fprintf(errorDump, "In cycle %u: Write $0 Error\n", cycle);
     }
     return InstAction::CONTINUE;
 }
 
-InstAction InstSimulator::detectNumberOverflow(const int& a, const int& b, const InstDataBin& inst) {
-    if (inst.getInstType() == InstType::R) {
-        switch (inst.getFunct()) {
-            case 0x20u:
-                if (InstErrorDetector::isOverflowed(a, b, InstOpType::ADD)) {
-                    fprintf(errorDump, "In cycle %u: Number Overflow\n", cycle);
-                }
-                return InstAction::CONTINUE;
-            case 0x22u:
-                if (InstErrorDetector::isOverflowed(a, b, InstOpType::SUB)) {
-                    fprintf(errorDump, "In cycle %u: Number Overflow\n", cycle);
-                }
-                return InstAction::CONTINUE;
-            default:
-                return InstAction::CONTINUE;
-        }
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+InstAction InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::detectNumberOverflow(const int& a, const int& b, const InstOpType& op) {
+    if (ErrorSink::enabled && InstErrorDetector::isOverflowed(a, b, op)) {
+        fprintf(errorDump, "In cycle %u: Number Overflow\n", cycle);
     }
-    else if (inst.getInstType() == InstType::I) {
-        switch (inst.getOpCode()) {
-            case 0x08u:
-            case 0x23u:
-            case 0x21u:
-            case 0x25u:
-            case 0x20u:
-            case 0x24u:
-            case 0x2Bu:
-            case 0x29u:
-            case 0x28u:
-                if (InstErrorDetector::isOverflowed(a, b, InstOpType::ADD)) {
-                    fprintf(errorDump, "In cycle %u: Number Overflow\n", cycle);
-                }
-                return InstAction::CONTINUE;
-            default:
-                return InstAction::CONTINUE;
-        }
+    if (ErrorSink::enabled && !SnapshotSink::enabled && loopAccel && loopAccel->isTracing()) {
+        loopAccel->recordOperands(a, b, op);
     }
-    else {
-        return InstAction::CONTINUE;
+    return InstAction::CONTINUE;
+}
+
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+InstAction InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::detectMemAddrOverflow(const unsigned& addr, const InstSize& type) {
+    if (memory.getModel() == InstMemoryModel::FLAT && !InstErrorDetector::isValidMemoryAddr(addr, type)) {
+        if (ErrorSink::enabled) {
+            fprintf(errorDump, "In cycle %u: Address Overflow\n", cycle);
+        }
+        alive = false;
+        return InstAction::HALT;
     }
+    return InstAction::CONTINUE;
 }
 
-InstAction InstSimulator::detectMemAddrOverflow(const unsigned& addr, const InstDataBin& inst) {
-    switch (inst.getOpCode()) {
-        case 0x23u:
-        case 0x2Bu:
-            if (!InstErrorDetector::isValidMemoryAddr(addr, InstSize::WORD)) {
-                fprintf(errorDump, "In cycle %u: Address Overflow\n", cycle);
-                alive = false;
-                return InstAction::HALT;
-            }
-            return InstAction::CONTINUE;
-        case 0x21u:
-        case 0x25u:
-        case 0x29u:
-            if (!InstErrorDetector::isValidMemoryAddr(addr, InstSize::HALF)) {
-                fprintf(errorDump, "In cycle %u: Address Overflow\n", cycle);
-                alive = false;
-                return InstAction::HALT;
-            }
-            return InstAction::CONTINUE;
-        case 0x20u:
-        case 0x24u:
-        case 0x28u:
-            if (!InstErrorDetector::isValidMemoryAddr(addr, InstSize::BYTE)) {
-                fprintf(errorDump, "In cycle %u: Address Overflow\n", cycle);
-                alive = false;
-                return InstAction::HALT;
-            }
-            return InstAction::CONTINUE;
-        default:
-            return InstAction::CONTINUE;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+InstAction InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::detectDataMisaligned(const unsigned& addr, const InstSize& type) {
+    if (!InstErrorDetector::isAlignedAddr(addr, type)) {
+        if (ErrorSink::enabled) {
+            fprintf(errorDump, "In cycle %u: Misalignment Error\n", cycle);
+        }
+        alive = false;
+        return InstAction::HALT;
     }
+    return InstAction::CONTINUE;
 }
 
-InstAction InstSimulator::detectDataMisaligned(const unsigned& addr, const InstDataBin& inst) {
-    switch (inst.getOpCode()) {
-        case 0x23u:
-        case 0x2Bu:
-            if (!InstErrorDetector::isAlignedAddr(addr, InstSize::WORD)) {
-                fprintf(errorDump, "In cycle %u: Misalignment Error\n", cycle);
-                alive = false;
-                return InstAction::HALT;
-            }
-            return InstAction::CONTINUE;
-        case 0x21u:
-        case 0x25u:
-        case 0x29u:
-            if (!InstErrorDetector::isAlignedAddr(addr, InstSize::HALF)) {
-                fprintf(errorDump, "In cycle %u: Misalignment Error\n", cycle);
-                alive = false;
-                return InstAction::HALT;
-            }
-            return InstAction::CONTINUE;
-        case 0x20u:
-        case 0x24u:
-        case 0x28u:
-            if (!InstErrorDetector::isAlignedAddr(addr, InstSize::BYTE)) {
-                fprintf(errorDump, "In cycle %u: Misalignment Error\n", cycle);
-                alive = false;
-                return InstAction::HALT;
-            }
-            return InstAction::CONTINUE;
-        default:
-            return InstAction::CONTINUE;
+template<typename SnapshotSink, typename ErrorSink, typename HazardTrace, typename StatsCollector>
+InstAction InstSimulator<SnapshotSink, ErrorSink, HazardTrace, StatsCollector>::detectMemAccess(const unsigned& addr, const InstSize& type) {
+    InstAction action[2];
+    action[0] = detectMemAddrOverflow(addr, type);
+    action[1] = detectDataMisaligned(addr, type);
+    if (action[0] == InstAction::HALT || action[1] == InstAction::HALT) {
+        return InstAction::HALT;
     }
+    return InstAction::CONTINUE;
 }
 
+template class InstSimulator<InstSnapshotFile, InstErrorFile, InstHazardTrace, InstStatsNone>;
+template class InstSimulator<InstSnapshotFile, InstErrorFile, InstHazardTrace, InstStatsCounter>;
+template class InstSimulator<InstSnapshotBinary, InstErrorFile, InstHazardTrace, InstStatsNone>;
+template class InstSimulator<InstSnapshotBinary, InstErrorFile, InstHazardTrace, InstStatsCounter>;
+template class InstSimulator<InstSnapshotNone, InstErrorFile, InstHazardNone, InstStatsNone>;
+template class InstSimulator<InstSnapshotNone, InstErrorFile, InstHazardNone, InstStatsCounter>;
+template class InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardNone, InstStatsNone>;
+template class InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardNone, InstStatsCounter>;
+template class InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardTrace, InstStatsCounter>;
+
 } /* namespace lb */
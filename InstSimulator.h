@@ -10,26 +10,64 @@
 
 #include <cstdio>
 #include <cstdlib>
-#include <deque>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "InstAllocCounter.h"
+#include "InstCheckpoint.h"
+#include "InstCoSimulator.h"
+#include "InstCycleTrace.h"
+#include "InstDecodeCache.h"
 #include "InstDecoder.h"
 #include "InstMemory.h"
 #include "InstDataBin.h"
 #include "InstErrorDetector.h"
+#include "InstFunctionalSimulator.h"
+#include "InstHistory.h"
+#include "InstIntervalModel.h"
+#include "InstLoopAccel.h"
 #include "InstType.h"
+#include "InstWatchdog.h"
+#include "InstPipeline.h"
 #include "InstPipelineData.h"
+#include "InstPolicy.h"
+#include "InstSampling.h"
+#include "InstTrace.h"
 
 namespace lb {
 
+/**
+ * five-stage pipeline simulator, specialized at compile time,
+ * a disabled policy compiles to nothing
+ * @param SnapshotSink per-cycle snapshot (InstSnapshotFile, InstSnapshotNone)
+ * @param ErrorSink error dump (InstErrorFile, InstErrorNone)
+ * @param HazardTrace forwarding annotations (InstHazardTrace, InstHazardNone)
+ * @param StatsCollector cycle statistics (InstStatsNone, InstStatsCounter)
+ */
+template<typename SnapshotSink = InstSnapshotFile, typename ErrorSink = InstErrorFile,
+         typename HazardTrace = InstHazardTrace, typename StatsCollector = InstStatsNone>
 class InstSimulator {
-private:
-    constexpr static int MAXN = 4096;
-
 private:
     const static unsigned IF;
     const static unsigned ID;
     const static unsigned EX;
     const static unsigned DM;
     const static unsigned WB;
+    // a snapshot is at most 32 registers, pc and five latches of about 80 characters
+    constexpr static unsigned SNAPSHOT_BUFFER = 2048u;
+
+private:
+    typedef void (InstSimulator::*InstStageHandler)(InstPipelineData&);
+
+    // reverse search predicate, true if the coming cycle writes the location
+    typedef bool (InstSimulator::*InstWriteMatcher)(const unsigned&);
+    // true if the checkpoint interval may write the location
+    typedef bool (InstSimulator::*InstWriteFilter)(const InstHistoryEntry&, const unsigned&);
+
+    // stage handlers indexed by InstExOp, InstDmOp, InstWbOp
+    const static InstStageHandler exHandler[];
+    const static InstStageHandler dmHandler[];
+    const static InstStageHandler wbHandler[];
 
 public:
     InstSimulator();
@@ -38,33 +76,298 @@ public:
 
     void init();
 
+    /**
+     * select data memory model, resets memory, call before loadImageI, loadImageD
+     * @param model FLAT(1 KiB, default), PAGED(32-bit) or
+     *              UNIFIED(32-bit, instructions loaded into and fetched from data memory,
+     *              dimage is loaded after iimage and overwrites it where they overlap,
+     *              callers must refuse overlapping images)
+     */
+    void setMemoryModel(const InstMemoryModel& model);
+
     void loadImageI(const unsigned* src, const unsigned& len, const unsigned& pc);
 
+    /**
+     * load instruction image without copying, decoded lazily on fetch
+     * @param src instruction words
+     * @param pc address of the first word
+     */
+    void loadImageI(std::vector<unsigned>&& src, const unsigned& pc);
+
     void loadImageD(const unsigned* src, const unsigned& len, const unsigned& sp);
 
     void setLogFile(FILE* snapshot, FILE* errorDump);
 
-    void simulate();
+    /**
+     * data memory latency, a load or store holds the whole pipeline for latency cycles in DM,
+     * the held cycles change nothing but the cycle count, simulate() and resume() skip them
+     * at once and repeat the held snapshot for each of them
+     * @param latency cycles per access, at least 1(default, no hold), kept by init()
+     */
+    void setMemoryLatency(const unsigned& latency);
+
+    /**
+     * cycle accurate simulation,
+     * with fastForward, the first fastForward instructions run on the functional core,
+     * the pipeline then starts drained(all nop) at the next pc, cycles count from the hand-off
+     * @param fastForward number of instructions to execute functionally first
+     * @return false if stopped at the cycle limit or by the watchdog, resume() continues
+     */
+    bool simulate(const unsigned& fastForward = 0u);
+
+    /**
+     * continue cycle accurate simulation from the current state,
+     * after simulate() stopped at the cycle limit or restoreCheckpoint()
+     * @return false if stopped at the cycle limit or by the watchdog
+     */
+    bool resume();
+
+    /**
+     * stop simulate() and resume() when cycle reaches limit, reset by init()
+     * @param limit cycle number, 0xFFFFFFFF for none
+     */
+    void setCycleLimit(const unsigned& limit);
+
+    unsigned getCycle() const;
+
+    /**
+     * write full state to a checkpoint file, call between cycles:
+     * pc, cycle, statistics, memory latency and hold, latches, registers, memory and instruction image
+     * @param filePath checkpoint file
+     * @return false if the file can't be written
+     */
+    bool saveCheckpoint(const std::string& filePath) const;
+
+    /**
+     * replace state with a checkpoint written by saveCheckpoint(), no images needed,
+     * memory model and latency are taken from the checkpoint, output files are kept
+     * @param filePath checkpoint file
+     * @return false if the file can't be read, state is init() then
+     */
+    bool restoreCheckpoint(const std::string& filePath);
+
+    /**
+     * functional fast execution, no pipeline timing,
+     * dumps final registers to snapshot, cycle number is instruction count,
+     * no binary snapshot
+     */
+    void simulateFunctional();
+
+    /**
+     * sampled simulation(SMARTS), needs a counting StatsCollector,
+     * alternates functional fast-forward with detailed pipeline windows,
+     * a window starts drained and is left without draining:
+     * the functional core resumes at the oldest instruction not written back,
+     * which is safe to re-execute as it has at most accessed memory
+     * @param config period, window, warmup and error bound
+     * @param samples per-window measurements, cleared first
+     */
+    void simulateSampled(const InstSamplingConfig& config, InstSampleSet& samples);
+
+    /**
+     * functional run writing every instruction to trace for InstTraceReplay,
+     * runs past a halt like the pipeline does, until InstPipeline::STAGES halts in a row
+     * or a fatal memory error, then the two instructions behind the fault, in EX and ID
+     * when it stops the pipeline. no output files. self-modifying code is traced as executed, the pipeline
+     * runs the stale word for the instructions fetched before the store
+     * @param trace trace open for write, ended here
+     * @param maxInst instructions recorded at most, the trace ends with LIMIT then
+     * @return number of instructions recorded
+     */
+    unsigned recordTrace(InstTrace& trace, const unsigned& maxInst);
+
+    /**
+     * functional run of recordTrace() feeding an interval model instead of a trace,
+     * at the memory latency set, an estimate of simulate() without the pipeline
+     * @param model estimate, init() first
+     * @param maxInst instructions executed at most
+     * @return number of instructions executed
+     */
+    unsigned estimateInterval(InstIntervalModel& model, const unsigned& maxInst);
+
+    const StatsCollector& getStats() const;
+
+    /**
+     * reverse debugging, start at cycle 0 after the images are loaded,
+     * a checkpoint is taken every interval cycles, the one at cycle 0 is always kept,
+     * memory between checkpoints is kept as per-page undo journals
+     * @param interval cycles between checkpoints, bounds the replay of every move
+     * @param depth number of checkpoints kept, older ones are folded into cycle 0
+     */
+    void startDebug(const unsigned& interval, const unsigned& depth);
+
+    /**
+     * debugging: one cycle forward, no-op once finished or halted, after startDebug(),
+     * a cycle halted by a fatal error does not complete, the state stays before it
+     * @return false if no cycle completed
+     */
+    bool step();
+
+    /**
+     * debugging: move to the state after target cycles,
+     * backwards restores the nearest checkpoint and replays,
+     * stops early at the end of the program or a fatal error
+     * @param target number of cycles executed
+     */
+    void gotoCycle(const unsigned& target);
+
+    /**
+     * debugging: move back to just after the last write back to reg,
+     * writes by the last executed cycle are skipped so repeated calls keep going back
+     * @return false if there is none, the state is unchanged then
+     */
+    bool findLastRegWrite(const unsigned& reg);
+
+    /**
+     * debugging: move back to just after the last store covering byte addr,
+     * same rules as findLastRegWrite()
+     */
+    bool findLastMemWrite(const unsigned& addr);
+
+    /**
+     * false once finished or halted by a fatal error
+     */
+    bool isRunning();
+
+    /**
+     * false once halted by a fatal error
+     */
+    bool isAlive() const;
+
+    /**
+     * debugging: print the state as the snapshot of the last executed cycle
+     */
+    void dumpState(FILE* fp);
+
+    /**
+     * debugging: data memory word holding addr
+     * @return false if addr is outside FLAT memory
+     */
+    bool peekMemory(const unsigned& addr, unsigned& val);
+
+    /**
+     * loop acceleration, iterations of a proved affine loop are skipped, see InstLoopAccel,
+     * no effect with snapshots, which need every cycle, or with UNIFIED memory
+     * @param enabled accelerator allocated on first use, kept by init()
+     */
+    void setLoopAcceleration(const bool& enabled);
+
+    /**
+     * cycles skipped by loop acceleration since init()
+     */
+    unsigned getSkippedCycles() const;
+
+    /**
+     * infinite loop watchdog, see InstWatchdog, the machine state is sampled at
+     * every taken backward branch or jump, simulate() and resume() stop once a state repeats,
+     * not with startDebug(), which journals memory itself
+     * @param enabled reset by init()
+     */
+    void setWatchdog(const bool& enabled);
+
+    /**
+     * the watchdog stopped the simulation, the program never halts
+     */
+    bool isLooping() const;
+
+    /**
+     * cycles executed when the repeating state was first seen, after isLooping()
+     */
+    unsigned getLoopCycle() const;
+
+    /**
+     * lockstep co-simulation, see InstCoSimulator, every retired instruction is checked
+     * against a functional reference by simulate(), not after fast-forward
+     * @param enabled checker allocated on first use, kept by init(),
+     * call before setMemoryModel, loadImageI, loadImageD
+     */
+    void setCoSimulation(const bool& enabled);
+
+    /**
+     * the pipeline wrote a register or memory word the reference did not
+     */
+    bool hasDiverged() const;
+
+    /**
+     * print the first divergence: cycle, instruction and the differing value
+     */
+    void reportDivergence(FILE* fp) const;
 
 private:
     bool alive;
     unsigned pc;
     unsigned pcOriginal;
     unsigned cycle;
+    unsigned cycleLimit;
     FILE* snapshot;
     FILE* errorDump;
     InstMemory memory;
-    InstDataBin instList[MAXN];
+    InstDecodeCache decodeCache;
+    InstFunctionalSimulator functional;
+    StatsCollector stats;
+    InstHistory history;
+    unsigned historyInterval;
+    // debugging: cycles executed before the one a fatal error halted, the state stays there
+    unsigned haltCycle;
+    InstLoopAccel* loopAccel;
+    InstCoSimulator* coSim;
+    unsigned skippedCycles;
+    InstWatchdog watchdog;
+    bool watching;
+    bool looping;
+    // the cycle took a backward branch or jump, set by instID()
+    bool backEdge;
+    unsigned memoryLatency;
+    // held cycles left for the access in DM
+    unsigned memoryWait;
+    // the held snapshot after its cycle line, formatted once per hold,
+    // SNAPSHOT_BUFFER bytes allocated with text snapshots and latency > 1
+    char* heldBuffer;
+    // binary snapshot records, allocated for SnapshotSink::binary only
+    InstCycleTrace* cycleTrace;
 
 private:
-    std::deque<InstPipelineData> pipeline;
-    std::deque<InstElement> idForward;
-    std::deque<InstElement> exForward;
+    InstPipeline pipeline;
+    InstElementList<2> idForward;
+    InstElementList<2> exForward;
+    // register scoreboard, one bit per register for each stage
+    // write: pending writers, load: pending writers which are loads
+    unsigned scoreboardWrite[5];
+    unsigned scoreboardLoad[5];
 
 private:
     void dumpSnapshot(FILE* fp);
 
-    void dumpPipelineInfo(FILE* fp, const int stage);
+    /**
+     * snapshot of the current cycle while the pipeline is held, the same as the last one
+     */
+    void dumpHeldSnapshot(FILE* fp);
+
+    /**
+     * skip the held cycles up to the cycle limit, snapshots are written in bulk
+     */
+    void skipHeldCycles();
+
+    /**
+     * pc shown by the snapshots of held cycles
+     */
+    unsigned getHeldPc() const;
+
+    /**
+     * snapshot after its cycle line
+     * @param buffer SNAPSHOT_BUFFER bytes
+     * @return length, without the terminator
+     */
+    unsigned formatSnapshot(char* buffer, const unsigned& shownPc);
+
+    void formatRegister(char* buffer, unsigned& len, const unsigned& shownPc);
+
+    void formatPipelineInfo(char* buffer, unsigned& len, const int stage);
+
+    /**
+     * printf to buffer + len, cut at SNAPSHOT_BUFFER bytes, len is moved past the text
+     */
+    static void formatText(char* buffer, unsigned& len, const char* format, ...);
 
     void instIF();
 
@@ -76,8 +379,6 @@ private:
 
     void instWB();
 
-    void instPop();
-
     void instStall();
 
     void instUnstall();
@@ -86,21 +387,83 @@ private:
 
     void instSetDependency();
 
+    void instSetScoreboard();
+
     void instSetDependencyID();
 
     void instSetDependencyEX();
 
     bool instPredictBranch();
 
-    unsigned instALUR(const InstDataBin& inst);
+    unsigned instALUJ(const unsigned& instPc);
 
-    unsigned instALUI(const InstDataBin& inst);
+    void instEXNone(InstPipelineData& pipelineData);
 
-    unsigned instALUJ(const unsigned& instPc);
+    void instEXZero(InstPipelineData& pipelineData);
+
+    void instEXAdd(InstPipelineData& pipelineData);
+
+    void instEXAddu(InstPipelineData& pipelineData);
+
+    void instEXSub(InstPipelineData& pipelineData);
+
+    void instEXAnd(InstPipelineData& pipelineData);
+
+    void instEXOr(InstPipelineData& pipelineData);
+
+    void instEXXor(InstPipelineData& pipelineData);
+
+    void instEXNor(InstPipelineData& pipelineData);
+
+    void instEXNand(InstPipelineData& pipelineData);
 
-    unsigned instMemLoad(const unsigned& addr, const InstDataBin& inst);
+    void instEXSlt(InstPipelineData& pipelineData);
 
-    void instMemStore(const unsigned& addr, const unsigned& val, const InstDataBin& inst);
+    void instEXSll(InstPipelineData& pipelineData);
+
+    void instEXSrl(InstPipelineData& pipelineData);
+
+    void instEXSra(InstPipelineData& pipelineData);
+
+    void instEXAddi(InstPipelineData& pipelineData);
+
+    void instEXAddiu(InstPipelineData& pipelineData);
+
+    void instEXMemAddr(InstPipelineData& pipelineData);
+
+    void instEXLui(InstPipelineData& pipelineData);
+
+    void instEXAndi(InstPipelineData& pipelineData);
+
+    void instEXOri(InstPipelineData& pipelineData);
+
+    void instEXNori(InstPipelineData& pipelineData);
+
+    void instEXSlti(InstPipelineData& pipelineData);
+
+    void instDMNone(InstPipelineData& pipelineData);
+
+    void instDMLoadWord(InstPipelineData& pipelineData);
+
+    void instDMLoadHalf(InstPipelineData& pipelineData);
+
+    void instDMLoadHalfU(InstPipelineData& pipelineData);
+
+    void instDMLoadByte(InstPipelineData& pipelineData);
+
+    void instDMLoadByteU(InstPipelineData& pipelineData);
+
+    void instDMStoreWord(InstPipelineData& pipelineData);
+
+    void instDMStoreHalf(InstPipelineData& pipelineData);
+
+    void instDMStoreByte(InstPipelineData& pipelineData);
+
+    void instWBNone(InstPipelineData& pipelineData);
+
+    void instWBALUOut(InstPipelineData& pipelineData);
+
+    void instWBMDR(InstPipelineData& pipelineData);
 
     bool isNOP(const InstDataBin& inst);
 
@@ -108,10 +471,93 @@ private:
 
     bool isFinished();
 
+    /**
+     * cycle loop until finished, fatal error, cycle limit or watchdog
+     * @return false if stopped at the cycle limit or by the watchdog
+     */
+    bool simulateLoop();
+
+    /**
+     * one pipeline cycle, from WB back to IF, then hazards, snapshot and pc
+     */
+    void simulateCycle();
+
+    /**
+     * execute count instructions on the functional core from pc,
+     * leaves pc at the next instruction, alive false on a fatal error
+     * @param count number of instructions
+     * @return number of instructions executed
+     */
+    unsigned runFunctional(const unsigned& count);
+
+    /**
+     * detailed window from pc, pipeline starts drained,
+     * warmup instructions retire unmeasured, then count measured,
+     * leaves pc at the oldest unfinished instruction
+     * @return number of instructions retired
+     */
+    unsigned simulateWindow(const unsigned& warmup, const unsigned& count, InstSampleSet& samples);
+
+    /**
+     * recordTrace() for any sink with the write() and end() of InstTrace
+     */
+    template<typename TraceSink>
+    unsigned runTraced(TraceSink& trace, const unsigned& maxInst);
+
+    /**
+     * pc of the oldest instruction not yet written back
+     */
+    unsigned getResumePc();
+
+    /**
+     * counting builds: take the allocation count after the first cycle,
+     * abort if it moves afterwards
+     * @param allocBase allocation count after the first cycle
+     * @param taken false before the first cycle of this loop
+     */
+    void checkAllocation(unsigned& allocBase, bool& taken);
+
+    /**
+     * take a checkpoint at the current cycle and start its journal
+     */
+    void saveHistory();
+
+    /**
+     * roll back to checkpoint index, newer checkpoints are dropped
+     */
+    void loadHistory(const unsigned& index);
+
+    /**
+     * move back to just after the last cycle before the previous one matching match(arg),
+     * replays one checkpoint interval at a time, newest first,
+     * intervals rejected by filter(arg) are skipped without replay
+     */
+    bool findLastWrite(const InstWriteMatcher match, const InstWriteFilter filter, const unsigned& arg);
+
+    bool isRegWriteAt(const unsigned& reg);
+
+    bool isMemWriteAt(const unsigned& addr);
+
+    bool hasRegWrite(const InstHistoryEntry& entry, const unsigned& reg);
+
+    bool hasMemWrite(const InstHistoryEntry& entry, const unsigned& addr);
+
+    /**
+     * end of a cycle taking a backward branch or jump, the branch is in EX and its target in IF
+     */
+    void onBackEdge();
+
+    /**
+     * back-edge of beq, bne or bgtz, samples the loop and skips iterations once they are proved
+     */
+    void onLoopEdge();
+
     bool isMemoryLoad(const InstDataBin& inst);
 
     bool isMemoryStore(const InstDataBin& inst);
 
+    bool isMemoryAccess(const InstDataBin& inst);
+
     bool isBranch(const InstDataBin& inst);
 
     bool isBranchR(const InstDataBin& inst);
@@ -120,22 +566,42 @@ private:
 
     bool isBranchJ(const InstDataBin& inst);
 
-    bool hasToStall(const unsigned& dependency, const std::vector<unsigned>& dEX,
-                    const std::vector<unsigned>& dDM);
-
-    unsigned getDependency(std::vector<unsigned>& dEX, std::vector<unsigned>& dDM);
+    bool hasToStall(const unsigned& dEX, const unsigned& dDM);
 
     InstState checkIDDependency();
 
     InstAction detectWriteRegZero(const unsigned& addr);
 
-    InstAction detectNumberOverflow(const int& a, const int& b, const InstDataBin& inst);
+    InstAction detectNumberOverflow(const int& a, const int& b, const InstOpType& op);
+
+    InstAction detectMemAddrOverflow(const unsigned& addr, const InstSize& type);
 
-    InstAction detectMemAddrOverflow(const unsigned& addr, const InstDataBin& inst);
+    InstAction detectDataMisaligned(const unsigned& addr, const InstSize& type);
 
-    InstAction detectDataMisaligned(const unsigned& addr, const InstDataBin& inst);
+    InstAction detectMemAccess(const unsigned& addr, const InstSize& type);
 };
 
+// prebuilt instantiations, see InstSimulator.cpp
+typedef InstSimulator<InstSnapshotFile, InstErrorFile, InstHazardTrace, InstStatsNone> InstSimulatorFull;
+typedef InstSimulator<InstSnapshotFile, InstErrorFile, InstHazardTrace, InstStatsCounter> InstSimulatorFullStats;
+typedef InstSimulator<InstSnapshotBinary, InstErrorFile, InstHazardTrace, InstStatsNone> InstSimulatorBinary;
+typedef InstSimulator<InstSnapshotBinary, InstErrorFile, InstHazardTrace, InstStatsCounter> InstSimulatorBinaryStats;
+typedef InstSimulator<InstSnapshotNone, InstErrorFile, InstHazardNone, InstStatsNone> InstSimulatorError;
+typedef InstSimulator<InstSnapshotNone, InstErrorFile, InstHazardNone, InstStatsCounter> InstSimulatorErrorStats;
+typedef InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardNone, InstStatsNone> InstSimulatorQuiet;
+typedef InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardNone, InstStatsCounter> InstSimulatorQuietStats;
+typedef InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardTrace, InstStatsCounter> InstSimulatorDebug;
+
+extern template class InstSimulator<InstSnapshotFile, InstErrorFile, InstHazardTrace, InstStatsNone>;
+extern template class InstSimulator<InstSnapshotFile, InstErrorFile, InstHazardTrace, InstStatsCounter>;
+extern template class InstSimulator<InstSnapshotBinary, InstErrorFile, InstHazardTrace, InstStatsNone>;
+extern template class InstSimulator<InstSnapshotBinary, InstErrorFile, InstHazardTrace, InstStatsCounter>;
+extern template class InstSimulator<InstSnapshotNone, InstErrorFile, InstHazardNone, InstStatsNone>;
+extern template class InstSimulator<InstSnapshotNone, InstErrorFile, InstHazardNone, InstStatsCounter>;
+extern template class InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardNone, InstStatsNone>;
+extern template class InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardNone, InstStatsCounter>;
+extern template class InstSimulator<InstSnapshotNone, InstErrorNone, InstHazardTrace, InstStatsCounter>;
+
 } /* namespace lb */
 
 #endif /* INSTSIMULATOR_H_ */
@@ -0,0 +1,263 @@
+/*
+ * InstTrace.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include <cerrno>
+#include <cstring>
+#include "InstTrace.h"
+#include "InstDecoder.h"
+#include "InstUtility.h"
+
+namespace lb {
+
+constexpr unsigned InstTrace::MAGIC;
+constexpr unsigned InstTrace::VERSION;
+constexpr unsigned char InstTrace::FLAG_TAKEN;
+constexpr unsigned char InstTrace::FLAG_FAULT;
+constexpr unsigned char InstTrace::FLAG_NEW_OP;
+constexpr unsigned char InstTrace::FLAG_PC;
+constexpr unsigned char InstTrace::FLAG_END;
+
+InstTrace::InstTrace() {
+    this->fp = nullptr;
+    this->error = false;
+    this->pc = 0u;
+    this->count = 0u;
+    this->endReason = InstTraceEnd::NONE;
+}
+
+InstTrace::~InstTrace() {
+    if (fp) {
+        fclose(fp);
+    }
+}
+
+bool InstTrace::openWrite(const std::string& filePath, const unsigned& pc) {
+    this->filePath = filePath;
+    this->error = false;
+    this->pc = pc;
+    this->count = 0u;
+    this->endReason = InstTraceEnd::NONE;
+    opIndex.clear();
+    fp = fopen(filePath.c_str(), "wb");
+    if (!fp) {
+        fail(strerror(errno));
+        return false;
+    }
+    writeWord(MAGIC);
+    writeWord(VERSION);
+    writeWord(pc);
+    return !error;
+}
+
+bool InstTrace::openRead(const std::string& filePath) {
+    this->filePath = filePath;
+    this->error = false;
+    this->count = 0u;
+    this->endReason = InstTraceEnd::NONE;
+    ops.clear();
+    fp = fopen(filePath.c_str(), "rb");
+    if (!fp) {
+        fail(strerror(errno));
+        return false;
+    }
+    if (readWord() != MAGIC && !error) {
+        fail("not a trace");
+    }
+    if (error) {
+        return false;
+    }
+    const unsigned version = readWord();
+    if (!error && version != VERSION) {
+        fail("unsupported trace version");
+    }
+    pc = readWord();
+    return !error;
+}
+
+bool InstTrace::close() {
+    if (fp) {
+        if (fclose(fp) != 0) {
+            fail(strerror(errno));
+        }
+        fp = nullptr;
+    }
+    return !error;
+}
+
+bool InstTrace::good() const {
+    return !error;
+}
+
+void InstTrace::write(const unsigned& pc, const InstDataBin& inst, const unsigned& addr,
+                      const bool& taken, const bool& fault) {
+    if (error || endReason != InstTraceEnd::NONE) {
+        return;
+    }
+    const auto it = opIndex.find(inst.getInst());
+    unsigned flags = 0u;
+    flags |= taken ? FLAG_TAKEN : 0u;
+    flags |= fault ? FLAG_FAULT : 0u;
+    flags |= (it == opIndex.end()) ? FLAG_NEW_OP : 0u;
+    flags |= (pc != this->pc) ? FLAG_PC : 0u;
+    writeByte(flags);
+    if (flags & FLAG_PC) {
+        writeWord(pc);
+    }
+    if (flags & FLAG_NEW_OP) {
+        const unsigned op = static_cast<unsigned>(opIndex.size());
+        opIndex[inst.getInst()] = op;
+        writeWord(inst.getInst());
+    }
+    else {
+        writeVarint(it->second);
+    }
+    if (hasAddr(inst)) {
+        writeWord(addr);
+    }
+    this->pc = nextPc(pc, inst, taken);
+    ++count;
+}
+
+void InstTrace::end(const InstTraceEnd& reason) {
+    if (error || endReason != InstTraceEnd::NONE) {
+        return;
+    }
+    writeByte(FLAG_END);
+    writeByte(static_cast<unsigned>(reason));
+    endReason = reason;
+}
+
+bool InstTrace::read(InstTraceRecord& record) {
+    if (error || endReason != InstTraceEnd::NONE) {
+        return false;
+    }
+    const unsigned flags = readByte();
+    if (error) {
+        return false;
+    }
+    if (flags & FLAG_END) {
+        const unsigned reason = readByte();
+        if (!error && (reason == 0u || reason > static_cast<unsigned>(InstTraceEnd::LIMIT))) {
+            fail("corrupted trace");
+        }
+        if (!error) {
+            endReason = static_cast<InstTraceEnd>(reason);
+        }
+        return false;
+    }
+    record.pc = (flags & FLAG_PC) ? readWord() : pc;
+    if (flags & FLAG_NEW_OP) {
+        const unsigned word = readWord();
+        record.op = static_cast<unsigned>(ops.size());
+        ops.push_back(InstDecoder::decodeInstBin(word));
+    }
+    else {
+        record.op = readVarint();
+        if (!error && record.op >= ops.size()) {
+            fail("corrupted trace");
+        }
+    }
+    if (error) {
+        return false;
+    }
+    const InstDataBin& inst = ops[record.op];
+    record.addr = hasAddr(inst) ? readWord() : 0u;
+    record.taken = (flags & FLAG_TAKEN) != 0u;
+    record.fault = (flags & FLAG_FAULT) != 0u;
+    pc = nextPc(record.pc, inst, record.taken);
+    ++count;
+    return !error;
+}
+
+InstTraceEnd InstTrace::getEnd() const {
+    return endReason;
+}
+
+const InstDataBin& InstTrace::getOp(const unsigned& op) const {
+    return ops[op];
+}
+
+unsigned InstTrace::getCount() const {
+    return count;
+}
+
+void InstTrace::fail(const char* reason) {
+    fprintf(stderr, "%s: %s\n", filePath.c_str(), reason);
+    error = true;
+}
+
+unsigned InstTrace::nextPc(const unsigned& pc, const InstDataBin& inst, const bool& taken) {
+    if (!taken || inst.isClass(InstClass::BRANCH_R)) {
+        return pc + 4;
+    }
+    else if (inst.isClass(InstClass::BRANCH_I)) {
+        return toUnsigned(toSigned(pc) + 4 + 4 * toSigned(inst.getC(), 16));
+    }
+    else {
+        return ((pc + 4) & 0xF0000000u) | (inst.getC() * 4);
+    }
+}
+
+bool InstTrace::hasAddr(const InstDataBin& inst) {
+    return inst.isClass(InstClass::LOAD) || inst.isClass(InstClass::STORE);
+}
+
+void InstTrace::writeByte(const unsigned& byte) {
+    if (!error && putc(static_cast<int>(byte & 0xFFu), fp) == EOF) {
+        fail(strerror(errno));
+    }
+}
+
+void InstTrace::writeWord(const unsigned& word) {
+    writeByte(word >> 24);
+    writeByte(word >> 16);
+    writeByte(word >> 8);
+    writeByte(word);
+}
+
+void InstTrace::writeVarint(unsigned val) {
+    while (val >= 0x80u) {
+        writeByte((val & 0x7Fu) | 0x80u);
+        val >>= 7;
+    }
+    writeByte(val);
+}
+
+unsigned InstTrace::readByte() {
+    if (error) {
+        return 0u;
+    }
+    const int c = getc(fp);
+    if (c == EOF) {
+        fail("truncated trace");
+        return 0u;
+    }
+    return static_cast<unsigned>(c);
+}
+
+unsigned InstTrace::readWord() {
+    unsigned word = 0u;
+    for (unsigned i = 0; i < 4u; ++i) {
+        word = (word << 8) | readByte();
+    }
+    return word;
+}
+
+unsigned InstTrace::readVarint() {
+    unsigned val = 0u;
+    for (unsigned shift = 0u; shift < 32u; shift += 7u) {
+        const unsigned byte = readByte();
+        val |= (byte & 0x7Fu) << shift;
+        if (!(byte & 0x80u)) {
+            return val;
+        }
+    }
+    fail("corrupted trace");
+    return 0u;
+}
+
+} /* namespace lb */
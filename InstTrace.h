@@ -0,0 +1,173 @@
+/*
+ * InstTrace.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTTRACE_H_
+#define INSTTRACE_H_
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "InstDataBin.h"
+
+namespace lb {
+
+/**
+ * one dynamic instruction of a trace
+ * op: micro-op id, index for InstTrace::getOp()
+ * addr: effective address, loads and stores only
+ * taken: branch or jump taken
+ * fault: stopped by address overflow or misalignment
+ */
+struct InstTraceRecord {
+    unsigned pc;
+    unsigned op;
+    unsigned addr;
+    bool taken;
+    bool fault;
+};
+
+/**
+ * why a trace ends
+ */
+enum class InstTraceEnd : unsigned char {
+    NONE, HALT, FAULT, LIMIT
+};
+
+/**
+ * dynamic instruction trace file by using C I/O,
+ * starts with magic "LBTR", format version and the first pc as big-endian words,
+ * then one record per instruction: a flag byte, the pc if it is not the one
+ * that follows from the previous record, the micro-op id as a 7-bit varint or,
+ * on its first use, the instruction word, and the effective address of loads and stores,
+ * a flag byte with END and the reason closes the trace.
+ * a record is 2 bytes, 6 for a load or store, micro-ops are decoded once on read.
+ * a failed read or write makes the trace bad, later calls do nothing
+ */
+class InstTrace {
+public:
+    constexpr static unsigned MAGIC = 0x4C425452u;
+    constexpr static unsigned VERSION = 1u;
+
+public:
+    InstTrace();
+
+    InstTrace(const InstTrace& that) = delete;
+
+    virtual ~InstTrace();
+
+    InstTrace& operator=(const InstTrace& that) = delete;
+
+    /**
+     * create filePath and write the header
+     * @param pc pc of the first instruction
+     * @return false if the file can't be created
+     */
+    bool openWrite(const std::string& filePath, const unsigned& pc);
+
+    /**
+     * open filePath and check the header
+     * @return false if the file can't be opened, or is not a trace of this version
+     */
+    bool openRead(const std::string& filePath);
+
+    /**
+     * close the file, flushes on write
+     * @return false if the trace went bad
+     */
+    bool close();
+
+    bool good() const;
+
+    /**
+     * append an instruction
+     * @param pc pc of the instruction
+     * @param inst instruction executed
+     * @param addr effective address, ignored unless inst is a load or store
+     * @param taken branch or jump taken
+     * @param fault stopped by a fatal memory error
+     */
+    void write(const unsigned& pc, const InstDataBin& inst, const unsigned& addr,
+               const bool& taken, const bool& fault);
+
+    /**
+     * append the end record, nothing can be written after it
+     */
+    void end(const InstTraceEnd& reason);
+
+    /**
+     * next instruction
+     * @return false at the end record or if the trace is bad
+     */
+    bool read(InstTraceRecord& record);
+
+    /**
+     * reason read from the end record, NONE before it or if the trace is cut short
+     */
+    InstTraceEnd getEnd() const;
+
+    /**
+     * micro-op read so far
+     * @param op micro-op id of a record read
+     */
+    const InstDataBin& getOp(const unsigned& op) const;
+
+    /**
+     * number of records written or read
+     */
+    unsigned getCount() const;
+
+    /**
+     * report reason and make the trace bad
+     */
+    void fail(const char* reason);
+
+private:
+    // record flags
+    constexpr static unsigned char FLAG_TAKEN = 0x01u;
+    constexpr static unsigned char FLAG_FAULT = 0x02u;
+    constexpr static unsigned char FLAG_NEW_OP = 0x04u;
+    constexpr static unsigned char FLAG_PC = 0x08u;
+    constexpr static unsigned char FLAG_END = 0x80u;
+
+private:
+    FILE* fp;
+    std::string filePath;
+    bool error;
+    // pc of the next record unless it carries its own
+    unsigned pc;
+    unsigned count;
+    InstTraceEnd endReason;
+    // write: instruction word -> micro-op id
+    std::unordered_map<unsigned, unsigned> opIndex;
+    // read: decoded micro-ops by id
+    std::vector<InstDataBin> ops;
+
+private:
+    /**
+     * pc following inst at pc, jr goes on sequentially, its target record carries a pc
+     */
+    static unsigned nextPc(const unsigned& pc, const InstDataBin& inst, const bool& taken);
+
+    static bool hasAddr(const InstDataBin& inst);
+
+    void writeByte(const unsigned& byte);
+
+    void writeWord(const unsigned& word);
+
+    void writeVarint(unsigned val);
+
+    unsigned readByte();
+
+    unsigned readWord();
+
+    unsigned readVarint();
+};
+
+} /* namespace lb */
+
+#endif /* INSTTRACE_H_ */
@@ -0,0 +1,184 @@
+/*
+ * InstTraceReplay.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include "InstTraceReplay.h"
+#include "InstDecoder.h"
+
+namespace lb {
+
+const unsigned InstTraceReplay::IF = 0u;
+const unsigned InstTraceReplay::ID = 1u;
+const unsigned InstTraceReplay::EX = 2u;
+const unsigned InstTraceReplay::DM = 3u;
+const unsigned InstTraceReplay::WB = 4u;
+
+InstTraceReplay::InstTraceReplay() {
+    bubble = makeLatch(InstDecoder::decodeInstBin(0u));
+    cycleLimit = 0xFFFFFFFFu;
+    memoryLatency = 1u;
+    init();
+}
+
+InstTraceReplay::~InstTraceReplay() {
+
+}
+
+void InstTraceReplay::init() {
+    for (unsigned i = 0; i < InstPipeline::STAGES; ++i) {
+        latch[i] = bubble;
+    }
+    ops.clear();
+    hasNext = false;
+    stalled = false;
+    flushed = false;
+    alive = true;
+    cycle = 0u;
+    memoryWait = 0u;
+    stats.init();
+}
+
+void InstTraceReplay::setMemoryLatency(const unsigned& latency) {
+    memoryLatency = latency ? latency : 1u;
+}
+
+void InstTraceReplay::setCycleLimit(const unsigned& limit) {
+    cycleLimit = limit;
+}
+
+unsigned InstTraceReplay::getCycle() const {
+    return cycle;
+}
+
+const InstStatsCounter& InstTraceReplay::getStats() const {
+    return stats;
+}
+
+bool InstTraceReplay::replay(InstTrace& trace) {
+    init();
+    hasNext = trace.read(next);
+    while (!isFinished()) {
+        if (cycle == cycleLimit) {
+            return false;
+        }
+        if (memoryWait) {
+            // held cycles change nothing, skipped at once
+            const unsigned room = cycleLimit - cycle;
+            const unsigned count = (memoryWait < room) ? memoryWait : room;
+            memoryWait -= count;
+            cycle += count;
+            stats.set(stats.getCycle() + count, stats.getRetire(), stats.getStall(), stats.getFlush());
+            continue;
+        }
+        if (!replayCycle(trace)) {
+            return false;
+        }
+        if (!alive) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool InstTraceReplay::replayCycle(InstTrace& trace) {
+    const bool wrongPath = latch[IF].branch && latch[IF].taken;
+    if (!stalled && !wrongPath && !hasNext &&
+        trace.getEnd() != InstTraceEnd::HALT && trace.getEnd() != InstTraceEnd::FAULT) {
+        // cut short, what follows is unknown
+        return false;
+    }
+    if (!latch[WB].nop) {
+        stats.onRetire();
+    }
+    if (latch[DM].fault) {
+        alive = false;
+        return true;
+    }
+    if (flushed) {
+        latch[IF] = bubble;
+        flushed = false;
+    }
+    latch[WB] = latch[DM];
+    latch[DM] = latch[EX];
+    if (!stalled) {
+        latch[EX] = latch[ID];
+        latch[ID] = latch[IF];
+        latch[IF] = fetch(trace);
+    }
+    else {
+        latch[EX] = bubble;
+    }
+    stalled = false;
+    checkID();
+    stats.onCycle();
+    ++cycle;
+    if (memoryLatency > 1u && latch[DM].memory) {
+        memoryWait = memoryLatency - 1u;
+    }
+    return true;
+}
+
+InstTraceReplay::InstTraceLatch InstTraceReplay::fetch(InstTrace& trace) {
+    if ((latch[ID].branch && latch[ID].taken) || !hasNext) {
+        return bubble;
+    }
+    while (ops.size() <= next.op) {
+        ops.push_back(makeLatch(trace.getOp(static_cast<unsigned>(ops.size()))));
+    }
+    InstTraceLatch ret = ops[next.op];
+    ret.taken = next.taken;
+    ret.fault = next.fault;
+    hasNext = trace.read(next);
+    return ret;
+}
+
+void InstTraceReplay::checkID() {
+    const InstTraceLatch& id = latch[ID];
+    if (id.nop || id.halt) {
+        return;
+    }
+    // a register written by both EX and DM depends on EX only
+    const unsigned dEX = id.readMask & latch[EX].writeMask;
+    const unsigned dDM = id.readMask & latch[DM].writeMask & ~latch[EX].writeMask;
+    if (dEX || dDM) {
+        const bool stall = (dEX & latch[EX].loadMask) || (dDM & latch[DM].loadMask) || (dEX && dDM) ||
+                           (id.branch ? dEX != 0u : dDM != 0u);
+        if (stall) {
+            stalled = true;
+            stats.onStall();
+            return;
+        }
+    }
+    if (id.branch && id.taken) {
+        flushed = true;
+        stats.onFlush();
+    }
+}
+
+bool InstTraceReplay::isFinished() const {
+    for (unsigned i = 0; i < InstPipeline::STAGES; ++i) {
+        if (!latch[i].halt) {
+            return false;
+        }
+    }
+    return true;
+}
+
+InstTraceReplay::InstTraceLatch InstTraceReplay::makeLatch(const InstDataBin& inst) {
+    InstTraceLatch ret;
+    ret.readMask = inst.getRegReadMask();
+    ret.writeMask = inst.getRegWriteMask();
+    ret.loadMask = inst.isClass(InstClass::LOAD) ? ret.writeMask : 0u;
+    ret.nop = inst.isClass(InstClass::NOP);
+    ret.halt = inst.isClass(InstClass::HALT);
+    ret.branch = inst.isClass(InstClass::BRANCH);
+    ret.memory = inst.isClass(InstClass::LOAD) || inst.isClass(InstClass::STORE);
+    ret.taken = false;
+    ret.fault = false;
+    return ret;
+}
+
+} /* namespace lb */
@@ -0,0 +1,128 @@
+/*
+ * InstTraceReplay.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTTRACEREPLAY_H_
+#define INSTTRACEREPLAY_H_
+
+#include <vector>
+#include "InstDataBin.h"
+#include "InstPipeline.h"
+#include "InstPolicy.h"
+#include "InstTrace.h"
+
+namespace lb {
+
+/**
+ * trace-driven timing, replays a trace recorded by InstSimulator::recordTrace()
+ * through the same stall, flush and memory hold rules as InstSimulator,
+ * latches hold register masks and the recorded branch outcome only, nothing is executed.
+ * cycles and statistics are those of InstSimulator on the program the trace was
+ * recorded from, one trace serves every memory latency.
+ * the wrong-path instruction fetched behind a taken branch is a nop, it is flushed anyway
+ */
+class InstTraceReplay {
+public:
+    InstTraceReplay();
+
+    InstTraceReplay(const InstTraceReplay& that) = delete;
+
+    virtual ~InstTraceReplay();
+
+    InstTraceReplay& operator=(const InstTraceReplay& that) = delete;
+
+    /**
+     * drain the latches, reset cycle and statistics, keeps latency and cycle limit
+     */
+    void init();
+
+    /**
+     * @param latency cycles per load or store in DM, at least 1(default)
+     */
+    void setMemoryLatency(const unsigned& latency);
+
+    /**
+     * @param limit cycle number, 0xFFFFFFFF for none
+     */
+    void setCycleLimit(const unsigned& limit);
+
+    /**
+     * replay trace from its first record, starts with init()
+     * @param trace trace open for read
+     * @return false if stopped at the cycle limit, at the end of a trace cut short
+     * by its instruction limit, or by a bad trace
+     */
+    bool replay(InstTrace& trace);
+
+    unsigned getCycle() const;
+
+    const InstStatsCounter& getStats() const;
+
+private:
+    const static unsigned IF;
+    const static unsigned ID;
+    const static unsigned EX;
+    const static unsigned DM;
+    const static unsigned WB;
+
+private:
+    /**
+     * latch contents timing depends on
+     */
+    struct InstTraceLatch {
+        unsigned readMask;
+        unsigned writeMask;
+        // writeMask of a load, 0 otherwise
+        unsigned loadMask;
+        bool nop;
+        bool halt;
+        bool branch;
+        bool memory;
+        bool taken;
+        bool fault;
+    };
+
+private:
+    InstTraceLatch latch[InstPipeline::STAGES];
+    InstTraceLatch bubble;
+    // micro-ops by id, made on first fetch
+    std::vector<InstTraceLatch> ops;
+    InstTraceRecord next;
+    bool hasNext;
+    bool stalled;
+    bool flushed;
+    bool alive;
+    unsigned cycle;
+    unsigned cycleLimit;
+    unsigned memoryLatency;
+    unsigned memoryWait;
+    InstStatsCounter stats;
+
+private:
+    /**
+     * one unheld cycle
+     * @return false if the trace has no instruction for IF
+     */
+    bool replayCycle(InstTrace& trace);
+
+    /**
+     * latch for the next record, a nop behind a taken branch or once the program ended
+     */
+    InstTraceLatch fetch(InstTrace& trace);
+
+    /**
+     * stall or flush decided for the instruction in ID, InstSimulator::instSetDependencyID()
+     */
+    void checkID();
+
+    bool isFinished() const;
+
+    static InstTraceLatch makeLatch(const InstDataBin& inst);
+};
+
+} /* namespace lb */
+
+#endif /* INSTTRACEREPLAY_H_ */
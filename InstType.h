@@ -14,7 +14,7 @@ namespace lb {
  * enum class for instruction elements
  * OPCODE, RS, RT, RD, C, FUNCT
  */
-enum class InstElementType : unsigned {
+enum class InstElementType : unsigned char {
     OPCODE, RS, RT, RD, C, FUNCT, UNDEF
 };
 
@@ -42,14 +42,65 @@ enum class InstAction : unsigned {
     CONTINUE, HALT
 };
 
+/**
+ * enum class for data memory model
+ * FLAT(1 KiB, out of range is Address Overflow), PAGED(32-bit, lazily allocated pages),
+ * UNIFIED(PAGED, instructions are fetched from the same memory)
+ */
+enum class InstMemoryModel : unsigned char {
+    FLAT, PAGED, UNIFIED
+};
+
 /**
  * enum class for instruction type
  * R-type, I-type, J-type, Specialized, Undefined
  */
-enum class InstType : unsigned {
+enum class InstType : unsigned char {
     R, I, J, S, UNDEF
 };
 
+/**
+ * bit flags for instruction class
+ * LOAD, STORE, BRANCH_R(jr), BRANCH_I(beq, bne, bgtz), BRANCH_J(j, jal), HALT, NOP
+ * BRANCH matches any of the branch flags
+ */
+enum class InstClass : unsigned char {
+    NONE = 0x00u,
+    LOAD = 0x01u,
+    STORE = 0x02u,
+    BRANCH_R = 0x04u,
+    BRANCH_I = 0x08u,
+    BRANCH_J = 0x10u,
+    BRANCH = 0x1Cu,
+    HALT = 0x20u,
+    NOP = 0x40u
+};
+
+/**
+ * EX stage operation of an instruction, resolved by decoder
+ * index of EX stage handler table
+ */
+enum class InstExOp : unsigned char {
+    NONE, ZERO, ADD, ADDU, SUB, AND, OR, XOR, NOR, NAND, SLT, SLL, SRL, SRA,
+    ADDI, ADDIU, MEMADDR, LUI, ANDI, ORI, NORI, SLTI
+};
+
+/**
+ * DM stage operation of an instruction, resolved by decoder
+ * index of DM stage handler table
+ */
+enum class InstDmOp : unsigned char {
+    NONE, LW, LH, LHU, LB, LBU, SW, SH, SB
+};
+
+/**
+ * WB stage operation of an instruction, resolved by decoder
+ * index of WB stage handler table
+ */
+enum class InstWbOp : unsigned char {
+    NONE, ALUOUT, MDR
+};
+
 /**
  * enum class for memory size type
  * WORD: 4 bytes
@@ -65,11 +116,39 @@ enum class InstSize : unsigned {
  * rs, rt, rd, etc.
  */
 struct InstElement {
-    unsigned val;
+    unsigned char val;
     InstElementType type;
 
     InstElement(unsigned val = 0, InstElementType type = InstElementType::UNDEF) :
-            val(val), type(type) { }
+            val(static_cast<unsigned char>(val)), type(type) { }
+};
+
+/**
+ * fixed capacity list of inst elements, trivially copyable
+ * supports range-based for, empty(), size(), at()
+ */
+template<unsigned N>
+class InstElementList {
+public:
+    InstElementList() : len(0u) { }
+
+    const InstElement* begin() const { return item; }
+
+    const InstElement* end() const { return item + len; }
+
+    bool empty() const { return len == 0u; }
+
+    unsigned size() const { return len; }
+
+    const InstElement& at(const unsigned& idx) const { return item[idx]; }
+
+    void push_back(const InstElement& val) { item[len++] = val; }
+
+    void clear() { len = 0u; }
+
+private:
+    InstElement item[N];
+    unsigned char len;
 };
 
 } /* namespace lb */
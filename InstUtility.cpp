@@ -8,6 +8,18 @@
 #include "InstUtility.h"
 
 namespace lb {
+std::string toHexString(const unsigned& val) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%#x", val);
+    return std::string(buf);
+}
+
+std::string toString(const unsigned& val) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u", val);
+    return std::string(buf);
+}
+
 std::string toUpperString(std::string val) {
     for (unsigned long long i = 0; i < val.length(); ++i) {
         val[i] = static_cast<char>(toupper(static_cast<int>(val[i])));
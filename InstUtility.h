@@ -9,6 +9,7 @@
 #define INSTUTILITY_H_
 
 #include <cctype>
+#include <cstdio>
 #include <sstream>
 #include <string>
 #include "InstType.h"
@@ -37,6 +38,20 @@ std::string toHexString(const Tp& val) {
     return oss.str();
 }
 
+/**
+ * to std::string, use hex-decimal, same format as toHexString<unsigned>,
+ * formatted by snprintf instead of stringstream
+ * @param val value to change to string
+ */
+std::string toHexString(const unsigned& val);
+
+/**
+ * to std::string, use decimal, same format as toString<unsigned>,
+ * formatted by snprintf instead of stringstream
+ * @param val value to change to string
+ */
+std::string toString(const unsigned& val);
+
 /**
  * to upper string, "abc" -> "ABC"
  * @param val string to process
@@ -0,0 +1,62 @@
+/*
+ * InstWatchdog.cpp
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#include <cstring>
+#include "InstWatchdog.h"
+
+namespace lb {
+
+constexpr unsigned InstWatchdog::STATE_WORDS;
+
+InstWatchdog::InstWatchdog() {
+    init();
+}
+
+InstWatchdog::~InstWatchdog() {
+
+}
+
+void InstWatchdog::init() {
+    savedCycle = 0u;
+    count = 0u;
+    power = 1u;
+    started = false;
+    journal.clear();
+}
+
+bool InstWatchdog::addEdge(const unsigned* state, const unsigned& cycle, InstMemory& memory) {
+    if (!started) {
+        started = true;
+        save(state, cycle, memory);
+        return false;
+    }
+    ++count;
+    if (!memcmp(state, saved, sizeof(saved)) && memory.matchesJournal(journal)) {
+        return true;
+    }
+    if (count == power) {
+        // Brent: the saved sample leaps ahead, the distance to catch doubles
+        save(state, cycle, memory);
+        power = (power < 0x80000000u) ? power * 2u : power;
+    }
+    return false;
+}
+
+unsigned InstWatchdog::getRepeatCycle() const {
+    return savedCycle;
+}
+
+void InstWatchdog::save(const unsigned* state, const unsigned& cycle, InstMemory& memory) {
+    memcpy(saved, state, sizeof(saved));
+    savedCycle = cycle;
+    count = 0u;
+    // capacity is kept, pages are copied again on their first store
+    journal.clear();
+    memory.beginJournal(&journal);
+}
+
+} /* namespace lb */
@@ -0,0 +1,69 @@
+/*
+ * InstWatchdog.h
+ *
+ *  Created on: 2026/10/17
+ *      Author: LittleBird
+ */
+
+#ifndef INSTWATCHDOG_H_
+#define INSTWATCHDOG_H_
+
+#include "InstMemory.h"
+
+namespace lb {
+
+/**
+ * infinite loop detector, Brent's cycle detection over machine states sampled at back-edges,
+ * a state is pc, latches and registers, copied here, and memory, journaled from the saved state on,
+ * states are compared exactly: memory only once the rest is equal,
+ * equal states prove the program never halts as the simulation is deterministic
+ */
+class InstWatchdog {
+public:
+    // pc, registers, latches IF to WB of instruction word, pc, ALUOut, MDR, valRs, valRt and flags
+    constexpr static unsigned STATE_WORDS = 68u;
+
+public:
+    InstWatchdog();
+
+    InstWatchdog(const InstWatchdog& that) = delete;
+
+    virtual ~InstWatchdog();
+
+    InstWatchdog& operator=(const InstWatchdog& that) = delete;
+
+    /**
+     * forget samples, the caller stops the memory journal
+     */
+    void init();
+
+    /**
+     * sample at a back-edge
+     * @param state STATE_WORDS words
+     * @param cycle cycles executed
+     * @return true if the machine state equals the saved one, it repeats forever
+     */
+    bool addEdge(const unsigned* state, const unsigned& cycle, InstMemory& memory);
+
+    /**
+     * cycles executed when the repeating state was saved
+     */
+    unsigned getRepeatCycle() const;
+
+private:
+    unsigned saved[STATE_WORDS];
+    unsigned savedCycle;
+    // samples since the saved one, which is replaced when count reaches power
+    unsigned count;
+    unsigned power;
+    bool started;
+    // memory pages as they were at the saved sample
+    InstMemoryJournal journal;
+
+private:
+    void save(const unsigned* state, const unsigned& cycle, InstMemory& memory);
+};
+
+} /* namespace lb */
+
+#endif /* INSTWATCHDOG_H_ */
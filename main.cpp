@@ -10,41 +10,659 @@
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <utility>
+#include <vector>
+#include "InstBatchSimulator.h"
+#include "InstDebugger.h"
 #include "InstSimulator.h"
 #include "InstImageReader.h"
+#include "InstTrace.h"
+#include "InstTraceReplay.h"
 
-int main() {
+namespace {
+
+// exit status of a run stopped by the watchdog
+constexpr int EXIT_CYCLE_BUDGET = 2;
+constexpr int EXIT_INFINITE_LOOP = 3;
+// exit status of a run the co-simulation checker rejected
+constexpr int EXIT_DIVERGED = 4;
+
+/**
+ * command line options passed to the simulator
+ */
+struct RunOptions {
+    lb::InstMemoryModel model;
+    bool functional;
+    bool stats;
+    unsigned fastForward;
+    bool sampled;
+    lb::InstSamplingConfig sampling;
+    std::string checkpoint;
+    unsigned checkpointAt;
+    std::string restore;
+    bool debug;
+    unsigned debugInterval;
+    unsigned debugDepth;
+    bool loopAccel;
+    unsigned maxCycles;
+    bool watchdog;
+    unsigned memLatency;
+    std::string batch;
+    bool coSim;
+    std::string traceRecord;
+    std::string traceReplay;
+    bool estimate;
+};
+
+/**
+ * @return exit status, EXIT_CYCLE_BUDGET or EXIT_INFINITE_LOOP if the watchdog stopped it,
+ * EXIT_DIVERGED if the co-simulation checker found a wrong write
+ */
+template<typename Simulator>
+int run(std::vector<unsigned>& inst, const unsigned& pc,
+         const std::vector<unsigned>& memory, const unsigned& sp,
+         FILE* snapShot, FILE* errorDump, const RunOptions& options) {
+    Simulator* simulator = new Simulator();
+    simulator->setLogFile(snapShot, errorDump);
+    if (!options.restore.empty()) {
+        if (!simulator->restoreCheckpoint(options.restore)) {
+            delete simulator;
+            exit(EXIT_FAILURE);
+        }
+    }
+    else {
+        simulator->setCoSimulation(options.coSim);
+        simulator->setMemoryModel(options.model);
+        simulator->loadImageI(std::move(inst), pc);
+        simulator->loadImageD(memory.data(), static_cast<unsigned>(memory.size()), sp);
+        simulator->setMemoryLatency(options.memLatency);
+    }
+    simulator->setLoopAcceleration(options.loopAccel);
+    simulator->setWatchdog(options.watchdog);
+    int status = EXIT_SUCCESS;
+    if (options.sampled) {
+        lb::InstSampleSet samples;
+        simulator->simulateSampled(options.sampling, samples);
+        samples.report(stdout, options.sampling);
+    }
+    else if (options.functional) {
+        simulator->simulateFunctional();
+    }
+    else {
+        const bool checkpointDue = !options.checkpoint.empty() && options.checkpointAt < options.maxCycles;
+        simulator->setCycleLimit(checkpointDue ? options.checkpointAt : options.maxCycles);
+        bool finished = options.restore.empty() ? simulator->simulate(options.fastForward) : simulator->resume();
+        if (!finished && checkpointDue && !simulator->isLooping()) {
+            // stopped at the checkpoint cycle
+            if (!simulator->saveCheckpoint(options.checkpoint)) {
+                delete simulator;
+                exit(EXIT_FAILURE);
+            }
+            simulator->setCycleLimit(options.maxCycles);
+            finished = simulator->resume();
+        }
+        if (!finished && simulator->isLooping()) {
+            fprintf(stderr, "watchdog: infinite loop, state after cycle %u repeats after cycle %u\n",
+                    simulator->getLoopCycle(), simulator->getCycle());
+            status = EXIT_INFINITE_LOOP;
+        }
+        else if (!finished) {
+            fprintf(stderr, "watchdog: cycle budget exhausted after cycle %u\n", simulator->getCycle());
+            status = EXIT_CYCLE_BUDGET;
+        }
+        if (simulator->hasDiverged()) {
+            simulator->reportDivergence(stderr);
+            status = EXIT_DIVERGED;
+        }
+        if (options.stats) {
+            simulator->getStats().report(stderr);
+            if (options.loopAccel) {
+                fprintf(stderr, "loop acceleration skipped %u cycles\n", simulator->getSkippedCycles());
+            }
+        }
+    }
+    delete simulator;
+    return status;
+}
+
+/**
+ * reverse debugger on stdin and stdout, no output files
+ */
+void debug(std::vector<unsigned>& inst, const unsigned& pc,
+           const std::vector<unsigned>& memory, const unsigned& sp, const RunOptions& options) {
+    lb::InstSimulatorDebug* simulator = new lb::InstSimulatorDebug();
+    simulator->setMemoryModel(options.model);
+    simulator->loadImageI(std::move(inst), pc);
+    simulator->loadImageD(memory.data(), static_cast<unsigned>(memory.size()), sp);
+    simulator->setMemoryLatency(options.memLatency);
+    lb::InstDebugger debugger(*simulator, options.debugInterval, options.debugDepth);
+    debugger.run(stdin, stdout);
+    delete simulator;
+}
+
+/**
+ * functional run recording a trace for replayTrace(), no output files
+ */
+void recordTrace(std::vector<unsigned>& inst, const unsigned& pc,
+                 const std::vector<unsigned>& memory, const unsigned& sp, const RunOptions& options) {
+    lb::InstTrace trace;
+    if (!trace.openWrite(options.traceRecord, pc)) {
+        exit(EXIT_FAILURE);
+    }
+    lb::InstSimulatorQuiet* simulator = new lb::InstSimulatorQuiet();
+    simulator->setMemoryModel(options.model);
+    simulator->loadImageI(std::move(inst), pc);
+    simulator->loadImageD(memory.data(), static_cast<unsigned>(memory.size()), sp);
+    simulator->recordTrace(trace, options.maxCycles);
+    delete simulator;
+    if (!trace.close()) {
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * pipeline timing of a recorded trace, statistics to stdout, no output files
+ * @return exit status, EXIT_CYCLE_BUDGET if stopped at the cycle limit or at the end of a trace cut short
+ */
+int replayTrace(const RunOptions& options) {
+    lb::InstTrace trace;
+    if (!trace.openRead(options.traceReplay)) {
+        exit(EXIT_FAILURE);
+    }
+    lb::InstTraceReplay* replay = new lb::InstTraceReplay();
+    replay->setMemoryLatency(options.memLatency);
+    replay->setCycleLimit(options.maxCycles);
+    const bool finished = replay->replay(trace);
+    int status = EXIT_SUCCESS;
+    if (!trace.good()) {
+        status = EXIT_FAILURE;
+    }
+    else if (!finished && replay->getCycle() == options.maxCycles) {
+        fprintf(stderr, "watchdog: cycle budget exhausted after cycle %u\n", replay->getCycle());
+        status = EXIT_CYCLE_BUDGET;
+    }
+    else if (!finished) {
+        fprintf(stderr, "trace: ends after %u instructions, replay stopped after cycle %u\n",
+                trace.getCount(), replay->getCycle());
+        status = EXIT_CYCLE_BUDGET;
+    }
+    replay->getStats().report(stdout);
+    delete replay;
+    trace.close();
+    return status;
+}
+
+/**
+ * interval model estimate of a cycle accurate run to stdout, no output files
+ */
+void estimate(std::vector<unsigned>& inst, const unsigned& pc,
+              const std::vector<unsigned>& memory, const unsigned& sp, const RunOptions& options) {
+    lb::InstSimulatorQuiet* simulator = new lb::InstSimulatorQuiet();
+    simulator->setMemoryModel(options.model);
+    simulator->loadImageI(std::move(inst), pc);
+    simulator->loadImageD(memory.data(), static_cast<unsigned>(memory.size()), sp);
+    simulator->setMemoryLatency(options.memLatency);
+    lb::InstIntervalModel model;
+    simulator->estimateInterval(model, options.maxCycles);
+    model.report(stdout);
+    delete simulator;
+}
+
+/**
+ * functional runs of one program on many data images, InstBatchSimulator::LANES at a time,
+ * iimage.bin is read from the working directory, dimage.bin from each listed directory,
+ * which also gets the output files
+ * @param listPath one directory per line
+ */
+void batch(const std::string& listPath, const bool& snapshotEnabled, const bool& errorDumpEnabled) {
+    FILE* list = fopen(listPath.c_str(), "r");
+    if (!list) {
+        fprintf(stderr, "%s: %s\n", listPath.c_str(), strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    unsigned pc = 0u;
+    std::vector<unsigned> inst;
+    lb::InstImageReader::readImageI("iimage.bin", inst, &pc);
+    lb::InstBatchSimulator* simulator = new lb::InstBatchSimulator();
+    simulator->loadImageI(std::move(inst), pc);
+    std::vector<FILE*> files;
+    std::vector<unsigned> memory;
+    char line[4096];
+    bool more = true;
+    while (more) {
+        more = fgets(line, sizeof(line), list) != nullptr;
+        if (more) {
+            line[strcspn(line, "\r\n")] = '\0';
+            if (!line[0]) {
+                continue;
+            }
+            const std::string dir(line);
+            unsigned sp = 0u;
+            lb::InstImageReader::readImageD(dir + "/dimage.bin", memory, &sp);
+            FILE* snapShot = snapshotEnabled ? fopen((dir + "/snapshot.rpt").c_str(), "w") : nullptr;
+            FILE* errorDump = errorDumpEnabled ? fopen((dir + "/error_dump.rpt").c_str(), "w") : nullptr;
+            if ((snapshotEnabled && !snapShot) || (errorDumpEnabled && !errorDump)) {
+                fprintf(stderr, "%s: %s\n", dir.c_str(), strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+            files.push_back(snapShot);
+            files.push_back(errorDump);
+            simulator->addLane(memory.data(), static_cast<unsigned>(memory.size()), sp, snapShot, errorDump);
+        }
+        if (simulator->getLaneCount() == lb::InstBatchSimulator::LANES || (!more && simulator->getLaneCount())) {
+            simulator->simulate();
+            simulator->clearLanes();
+            for (FILE* fp : files) {
+                if (fp) {
+                    fclose(fp);
+                }
+            }
+            files.clear();
+        }
+    }
+    fclose(list);
+    delete simulator;
+}
+
+/**
+ * INTERVAL[,DEPTH], depth keeps its default when omitted
+ */
+bool parseDebug(const char* arg, unsigned& interval, unsigned& depth) {
+    char* end = nullptr;
+    interval = static_cast<unsigned>(strtoul(arg, &end, 10));
+    if (end == arg || interval == 0u) {
+        return false;
+    }
+    if (!*end) {
+        return true;
+    }
+    if (*end != ',') {
+        return false;
+    }
+    arg = end + 1;
+    depth = static_cast<unsigned>(strtoul(arg, &end, 10));
+    return end != arg && !*end && depth >= 2u;
+}
+
+/**
+ * PERIOD[,WINDOW[,WARMUP]], window and warmup keep their defaults when omitted
+ */
+bool parseSampling(const char* arg, lb::InstSamplingConfig& config) {
+    unsigned* fields[3] = {&config.period, &config.window, &config.warmup};
+    for (unsigned i = 0; i < 3u; ++i) {
+        char* end = nullptr;
+        const unsigned long val = strtoul(arg, &end, 10);
+        if (end == arg) {
+            return false;
+        }
+        *fields[i] = static_cast<unsigned>(val);
+        if (!*end) {
+            return config.period > 0u && config.window > 0u;
+        }
+        if (*end != ',') {
+            return false;
+        }
+        arg = end + 1;
+    }
+    return false;
+}
+
+/**
+ * in UNIFIED memory both images share one address space, the data image would overwrite code
+ * @return true if the instruction image at pc and the data image at 0 share a word
+ */
+bool imagesOverlap(const unsigned& pc, const size_t& instLen, const size_t& dataLen) {
+    // the data image starts below any pc
+    return instLen && dataLen && pc < 4ull * dataLen;
+}
+
+void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-f|--functional] [--mode=full|error|quiet|binary] [--stats]"
+            " [--memory=flat|paged|unified]\n"
+            "       [--fast-forward=N] [--sample=PERIOD[,WINDOW[,WARMUP]]] [--sample-error=E]\n"
+            "       [--checkpoint=FILE --checkpoint-at=CYCLE] [--restore=FILE]"
+            " [--debug[=INTERVAL[,DEPTH]]]\n"
+            "       [--loop-accel] [--max-cycles=N] [--watchdog] [--mem-latency=N] [-f --batch=LIST]\n"
+            "       [--cosim] [--trace-record=FILE] [--trace-replay=FILE] [--estimate]\n", name);
+    fprintf(stderr, "  full:  snapshot and error dump (default)\n");
+    fprintf(stderr, "  error: error dump only\n");
+    fprintf(stderr, "  quiet: no output files\n");
+    fprintf(stderr, "  binary: snapshot.bin cycle records instead of snapshot.rpt, render writes the text\n");
+    fprintf(stderr, "  flat:  1 KiB data memory, Address Overflow past it (default)\n");
+    fprintf(stderr, "  paged: 32-bit data memory, 4 KiB pages allocated on first access\n");
+    fprintf(stderr, "  unified: paged, instructions live in data memory at their pc, stores may modify code,\n"
+            "           refused if the data image, loaded at 0, overlaps the instruction image\n");
+    fprintf(stderr, "  fast-forward: execute the first N instructions functionally, then pipeline\n");
+    fprintf(stderr, "  sample: every PERIOD instructions, WARMUP(8) then WINDOW(1000) in the pipeline,\n"
+            "          the rest functionally, CPI estimate to stdout, no output files\n");
+    fprintf(stderr, "  sample-error: wanted relative CPI error at 99.7%% confidence (0.03)\n");
+    fprintf(stderr, "  checkpoint: save full state to FILE before cycle CYCLE, then continue\n");
+    fprintf(stderr, "  restore: continue from a checkpoint instead of the images,\n"
+            "           output files start at the checkpoint cycle\n");
+    fprintf(stderr, "  debug: reverse debugger, commands on stdin, no output files,\n"
+            "         a checkpoint every INTERVAL(10000) cycles, DEPTH(1000) kept\n");
+    fprintf(stderr, "  loop-accel: skip iterations of loops proved affine, error and quiet modes,\n"
+            "              flat and paged memory\n");
+    fprintf(stderr, "  max-cycles: stop after cycle N, exit status %d\n", EXIT_CYCLE_BUDGET);
+    fprintf(stderr, "  watchdog: stop once the machine state repeats at a backward branch or jump,\n"
+            "            the program never halts, exit status %d\n", EXIT_INFINITE_LOOP);
+    fprintf(stderr, "  mem-latency: every load and store holds the pipeline N(1) cycles in DM,\n"
+            "               a restored run keeps the latency of its checkpoint\n");
+    fprintf(stderr, "  batch: functional runs of iimage.bin on the dimage.bin of every directory\n"
+            "         listed in LIST, lanes in lockstep, outputs in each directory, flat memory\n");
+    fprintf(stderr, "  cosim: check every retired instruction against a functional reference,\n"
+            "         report the first wrong register or memory write, exit status %d\n", EXIT_DIVERGED);
+    fprintf(stderr, "  trace-record: functional run writing every instruction to FILE, no output files,\n"
+            "                at most N instructions with --max-cycles=N\n");
+    fprintf(stderr, "  trace-replay: pipeline timing of a recorded FILE, no images or output files,\n"
+            "                statistics to stdout, with --mem-latency and --max-cycles\n");
+    fprintf(stderr, "  estimate: functional run estimating cycles and CPI of the pipeline to stdout,\n"
+            "            no output files, at most N instructions with --max-cycles=N\n");
+    exit(EXIT_FAILURE);
+}
+
+}
+
+int main(int argc, char** argv) {
+    // options
+    RunOptions options;
+    options.model = lb::InstMemoryModel::FLAT;
+    options.functional = false;
+    options.stats = false;
+    options.fastForward = 0u;
+    options.sampled = false;
+    options.sampling.period = 0u;
+    options.sampling.window = 1000u;
+    options.sampling.warmup = 8u;
+    options.sampling.errorBound = 0.03;
+    options.checkpointAt = 0u;
+    options.debug = false;
+    options.debugInterval = 10000u;
+    options.debugDepth = 1000u;
+    options.loopAccel = false;
+    options.maxCycles = 0xFFFFFFFFu;
+    options.watchdog = false;
+    options.memLatency = 1u;
+    options.coSim = false;
+    options.estimate = false;
+    bool checkpointAtSet = false;
+    bool snapshotEnabled = true;
+    bool snapshotBinary = false;
+    bool errorDumpEnabled = true;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-f") || !strcmp(argv[i], "--functional")) {
+            options.functional = true;
+        }
+        else if (!strcmp(argv[i], "--stats")) {
+            options.stats = true;
+        }
+        else if (!strcmp(argv[i], "--mode=full")) {
+            snapshotEnabled = true;
+            snapshotBinary = false;
+            errorDumpEnabled = true;
+        }
+        else if (!strcmp(argv[i], "--mode=error")) {
+            snapshotEnabled = false;
+            snapshotBinary = false;
+            errorDumpEnabled = true;
+        }
+        else if (!strcmp(argv[i], "--mode=quiet")) {
+            snapshotEnabled = false;
+            snapshotBinary = false;
+            errorDumpEnabled = false;
+        }
+        else if (!strcmp(argv[i], "--mode=binary")) {
+            snapshotEnabled = true;
+            snapshotBinary = true;
+            errorDumpEnabled = true;
+        }
+        else if (!strcmp(argv[i], "--memory=flat")) {
+            options.model = lb::InstMemoryModel::FLAT;
+        }
+        else if (!strcmp(argv[i], "--memory=paged")) {
+            options.model = lb::InstMemoryModel::PAGED;
+        }
+        else if (!strcmp(argv[i], "--memory=unified")) {
+            options.model = lb::InstMemoryModel::UNIFIED;
+        }
+        else if (!strncmp(argv[i], "--fast-forward=", 15)) {
+            char* end = nullptr;
+            options.fastForward = static_cast<unsigned>(strtoul(argv[i] + 15, &end, 10));
+            if (end == argv[i] + 15 || *end) {
+                usage(argv[0]);
+            }
+        }
+        else if (!strncmp(argv[i], "--sample=", 9)) {
+            if (!parseSampling(argv[i] + 9, options.sampling)) {
+                usage(argv[0]);
+            }
+            options.sampled = true;
+        }
+        else if (!strncmp(argv[i], "--sample-error=", 15)) {
+            char* end = nullptr;
+            options.sampling.errorBound = strtod(argv[i] + 15, &end);
+            if (end == argv[i] + 15 || *end || options.sampling.errorBound <= 0.0) {
+                usage(argv[0]);
+            }
+        }
+        else if (!strncmp(argv[i], "--checkpoint=", 13) && argv[i][13]) {
+            options.checkpoint = argv[i] + 13;
+        }
+        else if (!strncmp(argv[i], "--checkpoint-at=", 16)) {
+            char* end = nullptr;
+            options.checkpointAt = static_cast<unsigned>(strtoul(argv[i] + 16, &end, 10));
+            if (end == argv[i] + 16 || *end) {
+                usage(argv[0]);
+            }
+            checkpointAtSet = true;
+        }
+        else if (!strncmp(argv[i], "--restore=", 10) && argv[i][10]) {
+            options.restore = argv[i] + 10;
+        }
+        else if (!strcmp(argv[i], "--debug")) {
+            options.debug = true;
+        }
+        else if (!strncmp(argv[i], "--debug=", 8)) {
+            if (!parseDebug(argv[i] + 8, options.debugInterval, options.debugDepth)) {
+                usage(argv[0]);
+            }
+            options.debug = true;
+        }
+        else if (!strcmp(argv[i], "--loop-accel")) {
+            options.loopAccel = true;
+        }
+        else if (!strncmp(argv[i], "--max-cycles=", 13)) {
+            char* end = nullptr;
+            options.maxCycles = static_cast<unsigned>(strtoul(argv[i] + 13, &end, 10));
+            if (end == argv[i] + 13 || *end) {
+                usage(argv[0]);
+            }
+        }
+        else if (!strcmp(argv[i], "--cosim")) {
+            options.coSim = true;
+        }
+        else if (!strcmp(argv[i], "--estimate")) {
+            options.estimate = true;
+        }
+        else if (!strncmp(argv[i], "--trace-record=", 15) && argv[i][15]) {
+            options.traceRecord = argv[i] + 15;
+        }
+        else if (!strncmp(argv[i], "--trace-replay=", 15) && argv[i][15]) {
+            options.traceReplay = argv[i] + 15;
+        }
+        else if (!strcmp(argv[i], "--watchdog")) {
+            options.watchdog = true;
+        }
+        else if (!strncmp(argv[i], "--batch=", 8) && argv[i][8]) {
+            options.batch = argv[i] + 8;
+        }
+        else if (!strncmp(argv[i], "--mem-latency=", 14)) {
+            char* end = nullptr;
+            options.memLatency = static_cast<unsigned>(strtoul(argv[i] + 14, &end, 10));
+            if (end == argv[i] + 14 || *end || !options.memLatency) {
+                usage(argv[0]);
+            }
+        }
+        else {
+            usage(argv[0]);
+        }
+    }
+    if (options.checkpoint.empty() != !checkpointAtSet) {
+        usage(argv[0]);
+    }
+    if ((!options.checkpoint.empty() || !options.restore.empty()) &&
+        (options.functional || options.sampled || (options.fastForward && !options.restore.empty()))) {
+        // checkpoints hold pipeline state
+        usage(argv[0]);
+    }
+    if (options.debug && (options.functional || options.sampled || options.fastForward ||
+                          !options.checkpoint.empty() || !options.restore.empty())) {
+        usage(argv[0]);
+    }
+    if (options.loopAccel && (snapshotEnabled || options.functional || options.sampled || options.debug)) {
+        // skipped cycles have no snapshot
+        usage(argv[0]);
+    }
+    if ((options.watchdog || options.maxCycles != 0xFFFFFFFFu) &&
+        (options.functional || options.sampled || options.debug)) {
+        // cycle accurate runs only
+        usage(argv[0]);
+    }
+    if (options.memLatency != 1u && (options.functional || !options.restore.empty())) {
+        // no pipeline, or the latency is the checkpoint's
+        usage(argv[0]);
+    }
+    if (options.coSim && (options.functional || options.sampled || options.debug || options.fastForward ||
+                          !options.restore.empty() || options.loopAccel)) {
+        // the reference starts with the images and sees every retired instruction
+        usage(argv[0]);
+    }
+    if (!options.batch.empty() && (!options.functional || options.model != lb::InstMemoryModel::FLAT ||
+                                   options.stats || options.sampled || options.fastForward)) {
+        // lanes are functional with FLAT memory
+        usage(argv[0]);
+    }
+    const bool traced = !options.traceRecord.empty() || !options.traceReplay.empty() || options.estimate;
+    if (traced && (options.functional || options.sampled || options.debug || options.fastForward ||
+                   !options.checkpoint.empty() || !options.restore.empty() || options.loopAccel ||
+                   options.watchdog || options.coSim || !options.batch.empty())) {
+        usage(argv[0]);
+    }
+    if (options.estimate && (!options.traceRecord.empty() || !options.traceReplay.empty())) {
+        usage(argv[0]);
+    }
+    if (!options.traceRecord.empty() && (!options.traceReplay.empty() || options.memLatency != 1u)) {
+        // timing is chosen at replay
+        usage(argv[0]);
+    }
+    if (!options.traceReplay.empty() && options.model != lb::InstMemoryModel::FLAT) {
+        // memory errors are the recording's
+        usage(argv[0]);
+    }
+    if (snapshotBinary && options.functional) {
+        // records are per cycle
+        usage(argv[0]);
+    }
+    if (options.sampled) {
+        // estimates only, windows overlap fast-forwarded code so dumps would be partial
+        snapshotEnabled = false;
+        snapshotBinary = false;
+        errorDumpEnabled = false;
+        options.stats = true;
+    }
     // constant string filenames
     const std::string iimageFilename = "iimage.bin";
     const std::string dimageFilename = "dimage.bin";
-    const std::string snapshotFilename = "snapshot.rpt";
+    const std::string snapshotFilename = snapshotBinary ? "snapshot.bin" : "snapshot.rpt";
     const std::string errorDumpFilename = "error_dump.rpt";
-    // load iimage, dimage
-    unsigned iLen, dLen;
-    unsigned pc, sp;
-    unsigned inst[2048], memory[2048];
-    iLen = lb::InstImageReader::readImageI(iimageFilename.c_str(), inst, &pc);
-    dLen = lb::InstImageReader::readImageD(dimageFilename.c_str(), memory, &sp);
-    // open output file
-    FILE* snapShot;
-    FILE* errorDump;
-    snapShot = fopen(snapshotFilename.c_str(), "w");
-    if (!snapShot) {
-        fprintf(stderr, "%s: %s\n", snapshotFilename.c_str(), strerror(errno));
-        exit(EXIT_FAILURE);
+    if (!options.batch.empty()) {
+        batch(options.batch, snapshotEnabled, errorDumpEnabled);
+        return 0;
+    }
+    if (!options.traceReplay.empty()) {
+        return replayTrace(options);
+    }
+    // load iimage, dimage, a checkpoint replaces both
+    unsigned pc = 0u, sp = 0u;
+    std::vector<unsigned> inst, memory;
+    if (options.restore.empty()) {
+        lb::InstImageReader::readImageI(iimageFilename, inst, &pc);
+        lb::InstImageReader::readImageD(dimageFilename, memory, &sp);
     }
-    errorDump = fopen(errorDumpFilename.c_str(), "w");
-    if (!errorDump) {
-        fprintf(stderr, "%s: %s\n", errorDumpFilename.c_str(), strerror(errno));
+    if (options.model == lb::InstMemoryModel::UNIFIED && imagesOverlap(pc, inst.size(), memory.size())) {
+        fprintf(stderr, "%s: instructions at 0x%08X-0x%08llX overlap %s at 0x00000000-0x%08llX in unified memory\n",
+                iimageFilename.c_str(), pc, pc + 4ull * inst.size() - 1ull, dimageFilename.c_str(),
+                4ull * memory.size() - 1ull);
         exit(EXIT_FAILURE);
     }
-    // set simulator, start simulate
-    lb::InstSimulator simulator;
-    simulator.loadImageI(inst, iLen, pc);
-    simulator.loadImageD(memory, dLen, sp);
-    simulator.setLogFile(snapShot, errorDump);
-    simulator.simulate();
-    fclose(snapShot);
-    fclose(errorDump);
-    return 0;
+    if (options.debug) {
+        debug(inst, pc, memory, sp, options);
+        return 0;
+    }
+    if (!options.traceRecord.empty()) {
+        recordTrace(inst, pc, memory, sp, options);
+        return 0;
+    }
+    if (options.estimate) {
+        estimate(inst, pc, memory, sp, options);
+        return 0;
+    }
+    // open output file
+    FILE* snapShot = nullptr;
+    FILE* errorDump = nullptr;
+    if (snapshotEnabled) {
+        snapShot = fopen(snapshotFilename.c_str(), snapshotBinary ? "wb" : "w");
+        if (!snapShot) {
+            fprintf(stderr, "%s: %s\n", snapshotFilename.c_str(), strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (errorDumpEnabled) {
+        errorDump = fopen(errorDumpFilename.c_str(), "w");
+        if (!errorDump) {
+            fprintf(stderr, "%s: %s\n", errorDumpFilename.c_str(), strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+    // pick the specialized simulator, start simulate
+    int status = EXIT_SUCCESS;
+    if (snapshotBinary) {
+        if (options.stats) {
+            status = run<lb::InstSimulatorBinaryStats>(inst, pc, memory, sp, snapShot, errorDump, options);
+        }
+        else {
+            status = run<lb::InstSimulatorBinary>(inst, pc, memory, sp, snapShot, errorDump, options);
+        }
+    }
+    else if (snapshotEnabled) {
+        if (options.stats) {
+            status = run<lb::InstSimulatorFullStats>(inst, pc, memory, sp, snapShot, errorDump, options);
+        }
+        else {
+            status = run<lb::InstSimulatorFull>(inst, pc, memory, sp, snapShot, errorDump, options);
+        }
+    }
+    else if (errorDumpEnabled) {
+        if (options.stats) {
+            status = run<lb::InstSimulatorErrorStats>(inst, pc, memory, sp, snapShot, errorDump, options);
+        }
+        else {
+            status = run<lb::InstSimulatorError>(inst, pc, memory, sp, snapShot, errorDump, options);
+        }
+    }
+    else {
+        if (options.stats) {
+            status = run<lb::InstSimulatorQuietStats>(inst, pc, memory, sp, snapShot, errorDump, options);
+        }
+        else {
+            status = run<lb::InstSimulatorQuiet>(inst, pc, memory, sp, snapShot, errorDump, options);
+        }
+    }
+    if (snapShot) {
+        fclose(snapShot);
+    }
+    if (errorDump) {
+        fclose(errorDump);
+    }
+    return status;
 }